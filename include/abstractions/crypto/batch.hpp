@@ -0,0 +1,116 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_CRYPTO_BATCH
+#define ABSTRACTIONS_CRYPTO_BATCH
+
+#include <abstractions/abstractions.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace abstractions::crypto {
+
+    // Verifies many signatures at once. Entries which are repeated
+    // are only checked once and the rest are divided among threads.
+    template <typename pubkey, typename digest, typename signature>
+    struct batch {
+        struct entry {
+            pubkey Pubkey;
+            digest Digest;
+            signature Signature;
+        };
+
+        std::vector<entry> Entries;
+
+        batch() : Entries{} {}
+
+        void add(const pubkey& p, const digest& d, const signature& s) {
+            Entries.push_back(entry{p, d, s});
+        }
+
+        N size() const {
+            return Entries.size();
+        }
+
+        // true if every signature is valid. Stops at the first bad one.
+        bool verify(N threads = 0) const {
+            return check(threads, true).empty();
+        }
+
+        // the positions of the entries with bad signatures, in order.
+        std::vector<N> invalid(N threads = 0) const {
+            return check(threads, false);
+        }
+
+    private:
+        template <typename X>
+        static int compare(const X& a, const X& b) {
+            if (std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end())) return -1;
+            if (std::lexicographical_compare(b.begin(), b.end(), a.begin(), a.end())) return 1;
+            return 0;
+        }
+
+        static int compare(const entry& a, const entry& b) {
+            if (int c = compare(a.Pubkey, b.Pubkey)) return c;
+            if (int c = compare(a.Digest, b.Digest)) return c;
+            return compare(a.Signature, b.Signature);
+        }
+
+        std::vector<N> check(N threads, bool stop) const {
+            const N size = Entries.size();
+
+            // sort positions so that equal entries are next to one another
+            // and those with the same key are checked together.
+            std::vector<N> order(size);
+            for (N i = 0; i < size; i++) order[i] = i;
+            std::sort(order.begin(), order.end(), [this](N a, N b) -> bool {
+                return compare(Entries[a], Entries[b]) < 0;
+            });
+
+            std::vector<N> unique{};
+            for (N i = 0; i < size; i++)
+                if (i == 0 || compare(Entries[order[i - 1]], Entries[order[i]]) != 0) unique.push_back(i);
+
+            if (threads == 0) threads = std::thread::hardware_concurrency();
+            if (threads == 0) threads = 1;
+            if (threads > unique.size()) threads = unique.size();
+
+            std::vector<char> valid(unique.size(), 1);
+            std::atomic<N> next{0};
+            std::atomic<bool> failed{false};
+
+            auto worker = [this, &order, &unique, &valid, &next, &failed, stop]() {
+                for (N i = next++; i < unique.size() && !(stop && failed); i = next++) {
+                    const entry& e = Entries[order[unique[i]]];
+                    if (!e.Pubkey.verify(e.Digest, e.Signature)) {
+                        valid[i] = 0;
+                        failed = true;
+                    }
+                }
+            };
+
+            // the calling thread is one of the workers.
+            std::vector<std::thread> workers{};
+            workers.reserve(threads);
+            for (N i = 1; i < threads; i++) workers.emplace_back(worker);
+            worker();
+            for (std::thread& t : workers) t.join();
+
+            if (!failed) return {};
+
+            // every copy of a bad entry is bad.
+            std::vector<N> bad{};
+            for (N i = 0; i < unique.size(); i++) if (!valid[i]) {
+                N end = i + 1 < unique.size() ? unique[i + 1] : size;
+                for (N j = unique[i]; j < end; j++) bad.push_back(order[j]);
+            }
+            std::sort(bad.begin(), bad.end());
+            return bad;
+        }
+    };
+
+}
+
+#endif
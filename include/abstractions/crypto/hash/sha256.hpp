@@ -29,6 +29,67 @@ namespace abstractions {
         inline digest double_hash(const std::array<byte, n>& b) {
             return data::sha256::hash<32>(static_cast<const std::array<byte, 32>&>(data::sha256::hash<n>(b)));
         }
+        
+        // the internal state of sha256 after some number of 
+        // complete 64 byte blocks have been compressed. If many
+        // messages share the same prefix, the prefix only needs
+        // to be compressed once. 
+        struct midstate {
+            std::array<uint32, 8> State;
+            
+            // number of bytes that have been compressed. 
+            uint64 Length;
+            
+            // the initial state. 
+            midstate();
+            
+            // compress all complete blocks of the given bytes. 
+            midstate(const byte*, N size);
+            
+            // compress the remaining bytes of a message 
+            // with padding and return the digest. 
+            digest finish(const byte*, N size) const;
+        };
+        
+        template <N n>
+        inline midstate prefix(const std::array<byte, n>& b) {
+            return midstate{b.data(), n};
+        }
+        
+        // hash a message whose beginning has already been compressed into m. 
+        template <N n>
+        inline digest hash(const midstate& m, const std::array<byte, n>& b) {
+            return m.finish(b.data() + m.Length, n - m.Length);
+        }
+        
+        // the largest number of messages that are ever hashed at once. 
+        const N max_lanes = 16;
+        
+        // the number of messages that are hashed at once on this cpu, 
+        // which depends on the instruction sets it supports. 
+        N lanes();
+        
+        // finish count messages which all begin with the bytes compressed
+        // into m. tails holds the remaining size bytes of each message, 
+        // one after another. 
+        void finish(const midstate& m, const byte* tails, N size, N count, digest* out);
+        
+        // a way of finishing Lanes messages at once. 
+        struct implementation {
+            const char* Name;
+            N Lanes;
+            void (*Finish)(const midstate&, const byte* tails, N size, digest* out);
+        };
+        
+        // every implementation that this cpu can run, including the ones 
+        // that finish would not choose, so that they can be checked 
+        // against each other. 
+        std::vector<implementation> implementations();
+        
+        template <N n>
+        inline digest double_hash(const midstate& m, const std::array<byte, n>& b) {
+            return data::sha256::hash<32>(static_cast<const std::array<byte, 32>&>(hash<n>(m, b)));
+        }
     }
 
 }
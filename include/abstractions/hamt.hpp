@@ -0,0 +1,171 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_HAMT
+#define ABSTRACTIONS_HAMT
+
+#include <abstractions/abstractions.hpp>
+
+#include <algorithm>
+
+namespace abstractions {
+
+    // A persistent hash array mapped trie. Changing it makes a new trie
+    // which shares everything but the path to the change with the old
+    // one, so copies are cheap and old versions stay valid.
+    template <typename K, typename V, typename hash, typename equal>
+    struct hamt {
+        hamt() : Root{}, Size{0} {}
+
+        N size() const {
+            return Size;
+        }
+
+        bool empty() const {
+            return Size == 0;
+        }
+
+        // valid for as long as this version of the trie exists.
+        const V* find(const K& k) const {
+            N h = hash{}(k);
+            const node* n = Root.get();
+            for (N shift = 0; n != nullptr; shift += bits) {
+                if (n->leaf()) {
+                    for (const entry& e : n->Entries) if (e.Hash == h && equal{}(e.Key, k)) return &e.Value;
+                    return nullptr;
+                }
+                uint32 bit = uint32(1) << ((h >> shift) & mask);
+                if ((n->Bitmap & bit) == 0) return nullptr;
+                n = n->Children[position(n->Bitmap, bit)].get();
+            }
+            return nullptr;
+        }
+
+        bool contains(const K& k) const {
+            return find(k) != nullptr;
+        }
+
+        // add a value or replace the value that is there.
+        hamt insert(const K& k, const V& v) const {
+            bool added = false;
+            return hamt{insert(Root, entry{hash{}(k), k, v}, 0, added), Size + (added ? 1 : 0)};
+        }
+
+        hamt remove(const K& k) const {
+            if (!contains(k)) return *this;
+            return hamt{remove(Root, hash{}(k), k, 0), Size - 1};
+        }
+
+        // call f with every key and value, in no particular order.
+        template <typename function>
+        void for_each(function f) const {
+            if (Root != nullptr) for_each(*Root, f);
+        }
+
+    private:
+        constexpr static N bits = 5;
+        constexpr static N mask = 31;
+
+        struct entry {
+            N Hash;
+            K Key;
+            V Value;
+        };
+
+        // A node is either a branch or a leaf holding entries which all
+        // have the same hash. Children are shared, so copying a branch
+        // copies no entries.
+        struct node {
+            uint32 Bitmap;
+            std::vector<pointer<const node>> Children;
+            std::vector<entry> Entries;
+
+            bool leaf() const {
+                return !Entries.empty();
+            }
+        };
+
+        pointer<const node> Root;
+        N Size;
+
+        hamt(pointer<const node> r, N size) : Root{r}, Size{size} {}
+
+        static N position(uint32 bitmap, uint32 bit) {
+            return __builtin_popcount(bitmap & (bit - 1));
+        }
+
+        static uint32 bit(N h, N shift) {
+            return uint32(1) << ((h >> shift) & mask);
+        }
+
+        static pointer<const node> insert(const pointer<const node>& n, const entry& e, N shift, bool& added) {
+            if (n == nullptr) {
+                added = true;
+                return std::make_shared<const node>(node{0, {}, {e}});
+            }
+
+            if (n->leaf()) {
+                if (n->Entries[0].Hash == e.Hash) {
+                    node next = *n;
+                    auto old = std::find_if(next.Entries.begin(), next.Entries.end(), [&e](const entry& x) -> bool {
+                        return equal{}(x.Key, e.Key);
+                    });
+                    if (old != next.Entries.end()) *old = e;
+                    else {
+                        next.Entries.push_back(e);
+                        added = true;
+                    }
+                    return std::make_shared<const node>(std::move(next));
+                }
+
+                // the hashes differ further down, so put
+                // the leaf under a branch and try again.
+                pointer<const node> branch = std::make_shared<const node>(node{bit(n->Entries[0].Hash, shift), {n}, {}});
+                return insert(branch, e, shift, added);
+            }
+
+            uint32 b = bit(e.Hash, shift);
+            node next = *n;
+            N p = position(next.Bitmap, b);
+            if ((next.Bitmap & b) == 0) {
+                next.Bitmap |= b;
+                next.Children.insert(next.Children.begin() + p, insert(nullptr, e, shift + bits, added));
+            } else next.Children[p] = insert(next.Children[p], e, shift + bits, added);
+            return std::make_shared<const node>(std::move(next));
+        }
+
+        static pointer<const node> remove(const pointer<const node>& n, N h, const K& k, N shift) {
+            if (n->leaf()) {
+                if (n->Entries.size() == 1) return nullptr;
+                node next = *n;
+                next.Entries.erase(std::find_if(next.Entries.begin(), next.Entries.end(), [&k](const entry& x) -> bool {
+                    return equal{}(x.Key, k);
+                }));
+                return std::make_shared<const node>(std::move(next));
+            }
+
+            uint32 b = bit(h, shift);
+            node next = *n;
+            N p = position(next.Bitmap, b);
+            next.Children[p] = remove(next.Children[p], h, k, shift + bits);
+            if (next.Children[p] == nullptr) {
+                next.Bitmap &= ~b;
+                next.Children.erase(next.Children.begin() + p);
+            }
+
+            // a branch with nothing under it but a leaf becomes the leaf.
+            if (next.Children.empty()) return nullptr;
+            if (next.Children.size() == 1 && next.Children[0]->leaf()) return next.Children[0];
+            return std::make_shared<const node>(std::move(next));
+        }
+
+        template <typename function>
+        static void for_each(const node& n, function& f) {
+            for (const entry& e : n.Entries) f(e.Key, e.Value);
+            for (const pointer<const node>& c : n.Children) for_each(*c, f);
+        }
+    };
+
+}
+
+#endif
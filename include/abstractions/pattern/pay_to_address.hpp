@@ -13,16 +13,16 @@ namespace abstractions {
     namespace pattern {
         
         template <typename secret, typename pubkey, typename address>
-        struct pay_to_address final : public pattern::abstract::standard<secret, pubkey, bytes, address, bytes&> {
+        struct pay_to_address final : public pattern::abstract::standard<secret, pubkey, bytes, address, const bitcoin::sighash::context&> {
             using script = bytes;
-            using tx = bytes&;
+            using tx = const bitcoin::sighash::context&;
             
             address tag(pubkey k) const final override {
                 return k.address();
             }
             
             script pay(address a) const final override {
-                return abstractions::script::pay_to(a)->compile();
+                return abstractions::script::templates::pay_to(a);
             }
             
             list<address> recognize(script s) const final override {
@@ -30,7 +30,8 @@ namespace abstractions {
             }
             
             script redeem(satoshi amount, script script_pubkey, tx t, index i, secret k) const final override {
-                return abstractions::script::redeem_from_pay_to_address(bitcoin::sign(bitcoin::output{amount, script_pubkey}, t, i, k), k.to_public())->compile();
+                bitcoin::signature x = bitcoin::sign(bitcoin::output{amount, script_pubkey}, t, i, k);
+                return abstractions::script::redeem_from_pay_to_address(x, k.to_public())->compile();
             }
         
         };
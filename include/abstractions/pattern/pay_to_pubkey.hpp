@@ -15,16 +15,16 @@ namespace abstractions {
     namespace pattern {
         
         template <typename secret, typename pubkey>
-        struct pay_to_pubkey final : public pattern::abstract::standard<secret, pubkey, bytes, pubkey, bytes> {
+        struct pay_to_pubkey final : public pattern::abstract::standard<secret, pubkey, bytes, pubkey, const bitcoin::sighash::context&> {
             using script = bytes;
-            using tx = bytes&;
+            using tx = const bitcoin::sighash::context&;
             
             pubkey tag(pubkey k) const final override {
                 return k;
             }
             
             script pay(pubkey k) const final override {
-                return abstractions::script::pay_to(k)->compile();
+                return abstractions::script::templates::pay_to(k);
             }
             
             list<pubkey> recognize(script s) const final override {
@@ -32,7 +32,8 @@ namespace abstractions {
             }
             
             script redeem(satoshi amount, script s, tx t, index i, secret k) const final override {
-                return abstractions::script::redeem_from_pay_to_pubkey(bitcoin::sign(bitcoin::output{amount, s}, t, i, k))->compile();
+                bitcoin::signature x = bitcoin::sign(bitcoin::output{amount, s}, t, i, k);
+                return abstractions::script::redeem_from_pay_to_pubkey(x)->compile();
             }
         
         };
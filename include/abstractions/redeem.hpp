@@ -7,15 +7,25 @@
 #include <abstractions/pattern.hpp>
 #include <abstractions/transaction.hpp>
 
+#include <atomic>
+#include <thread>
+
 namespace abstractions {
     
-    // vertex is used to construct Bitcoin transactions.     
-    template <typename key, typename script, typename txid>
+    // vertex is used to construct Bitcoin transactions. Every input is 
+    // signed with the same context, which is made once from the 
+    // transaction with empty script signatures. By default the context 
+    // is that transaction itself. 
+    template <typename key, typename script, typename txid, 
+        typename context = abstractions::transaction<
+            typename input<txid, script>::representation, 
+            typename output<script>::representation>>
     struct vertex {
         using output = typename abstractions::output<script>::representation;
         using outpoint = typename abstractions::outpoint<txid>::representation;
         using input = typename input<txid, script>::representation;
-        using tx = const transaction<input, output>&;
+        using transaction = abstractions::transaction<input, output>;
+        using tx = const context&;
         using redeemer = typename pattern::abstract::redeemer<key, script, tx>&;
     
         struct spendable {
@@ -31,27 +41,83 @@ namespace abstractions {
             spendable() : Key{}, Output{}, Outpoint{} {}
             spendable(key k, output o, outpoint p, redeemer r) : Key{k}, Output{o}, Outpoint{p}, Redeemer{r} {}
             
-            input redeem(tx t, index i) const {
-                return input{Outpoint, Redeemer.redeem(Output.value(), Output.script(), t, i, Key)};
+            input redeem(tx c, index i) const {
+                return input{Outpoint, Redeemer.redeem(Output.value(), Output.script(), c, i, Key)};
             }
         };
     
         vector<spendable> Inputs;
         vector<output> Outputs;
         
-        vertex(vector<spendable> i, vector<output> o) : Inputs{i}, Outputs{o} {}
+        vertex(vector<spendable> i, vector<output> o) : Inputs{i}, Outputs{o}, Redeemed{0}, Spent{0} {
+            for (const spendable& x : Inputs) Redeemed += x.Output.value();
+            for (const output& x : Outputs) Spent += x.value();
+        }
         
         uint expected_size() const;
-        satoshi redeemed() const;
-        satoshi spent() const ;
+        
+        // inputs and outputs cannot change, so 
+        // their totals are found only once. 
+        satoshi redeemed() const {
+            return Redeemed;
+        }
+        
+        satoshi spent() const {
+            return Spent;
+        }
         
         satoshi fee() const {
             return [](satoshi r, satoshi s)->satoshi{if (s > r) return 0; return r - s;}(redeemed(), spent());
         }
         
-        tx redeem() const;
+        transaction redeem() const {
+            const context c{write()};
+            std::vector<input> inputs(Inputs.size());
+            for (index i = 0; i < inputs.size(); i++) inputs[i] = Inputs[i].redeem(c, i);
+            return transaction{inputs, Outputs};
+        }
+        
+        // sign the inputs on the given number of threads. Each input 
+        // is signed with the same context, so the result is the same 
+        // as that of redeem(). 0 means as many threads as the hardware 
+        // supports. 
+        transaction redeem(N threads) const {
+            const context c{write()};
+            const N size = Inputs.size();
+            std::vector<input> inputs(size);
+            
+            if (threads == 0) threads = std::thread::hardware_concurrency();
+            if (threads == 0) threads = 1;
+            if (threads > size) threads = size;
+            
+            // every worker writes only to the inputs it has taken, so 
+            // the order of the inputs does not depend on the schedule. 
+            std::atomic<N> next{0};
+            auto worker = [this, &c, &inputs, &next, size]() {
+                for (N i = next++; i < size; i = next++) inputs[i] = Inputs[i].redeem(c, i);
+            };
+            
+            // the calling thread is one of the workers. 
+            std::vector<std::thread> workers{};
+            workers.reserve(threads);
+            for (N i = 1; i < threads; i++) workers.emplace_back(worker);
+            worker();
+            for (std::thread& t : workers) t.join();
+            
+            return transaction{inputs, Outputs};
+        }
+        
     private:
-        tx write() const;
+        satoshi Redeemed;
+        satoshi Spent;
+        
+        // the transaction with every script signature empty. 
+        transaction write() const {
+            std::vector<input> inputs{};
+            inputs.reserve(Inputs.size());
+            for (const spendable& x : Inputs) inputs.push_back(input{x.Outpoint, script{}});
+            return transaction{inputs, Outputs};
+        }
     };
     
 }
@@ -0,0 +1,67 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_SCRIPT_FIXED
+#define ABSTRACTIONS_SCRIPT_FIXED
+
+#include <array>
+
+#include "script.hpp"
+
+namespace abstractions::script {
+    
+    // A script whose op codes are all known at compile time, with
+    // slots left for pushes of data of known size. Making a script 
+    // from it is a copy of the skeleton and a copy for each slot. 
+    template <N size, N slots>
+    struct fixed {
+        std::array<byte, size> Skeleton;
+        
+        // positions of the data of each slot. 
+        std::array<N, slots> Slots;
+        
+        constexpr fixed() : Skeleton{}, Slots{}, Length{0}, Filled{0} {}
+        
+        constexpr fixed& op(program::op o) {
+            Skeleton[Length++] = byte(o);
+            return *this;
+        }
+        
+        // a push of n bytes, where n is at most 75. 
+        constexpr fixed& slot(N n) {
+            op(program::op(n));
+            Slots[Filled++] = Length;
+            Length += n;
+            return *this;
+        }
+        
+        // a push of n zero bytes, where n is at most 75. 
+        constexpr fixed& zeros(N n) {
+            op(program::op(n));
+            for (N i = 0; i < n; i++) Skeleton[Length++] = 0;
+            return *this;
+        }
+        
+        // every byte and every slot has been accounted for. 
+        constexpr bool complete() const {
+            return Length == size && Filled == slots;
+        }
+        
+        byte* write(byte* b) const {
+            return std::copy(Skeleton.begin(), Skeleton.end(), b);
+        }
+        
+        // write data into a script that was written from this skeleton. 
+        template <typename X>
+        void fill(byte* script, N slot, const X& x) const {
+            std::copy(x.begin(), x.end(), script + Slots[slot]);
+        }
+        
+    private:
+        N Length;
+        N Filled;
+    };
+    
+}
+
+#endif
@@ -0,0 +1,114 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_SCRIPT_FLAT
+#define ABSTRACTIONS_SCRIPT_FLAT
+
+#include "script.hpp"
+
+namespace abstractions::script {
+    
+    // A program stored as a list of instructions rather than as a tree.  
+    // The data of every push is kept together in one buffer, so a 
+    // script can be built up with only a few allocations. 
+    struct flat : public program {
+        struct instruction {
+            op Code;
+            
+            // position and size of the data of a push. 
+            uint32 Offset;
+            uint32 Size;
+        };
+        
+        // whether an op code is followed by data. 
+        static bool is_push(op o) {
+            return o > OP_0 && o <= OP_PUSHDATA4;
+        }
+        
+        // the op code of the smallest push of the given data. 
+        static op push_code(const byte* data, N size);
+        
+        std::vector<instruction> Instructions;
+        std::vector<byte> Data;
+        
+        flat() : Instructions{}, Data{}, Length{0}, Valid{true} {}
+        
+        // read a compiled script. 
+        explicit flat(bytes& b) : flat{} {
+            read(b.data(), b.size());
+        }
+        
+        bool valid() const {
+            return Valid;
+        }
+        
+        N length() const final override {
+            return Length;
+        }
+        
+        void write(ostream& o) const final override {
+            o << compile();
+        }
+        
+        byte* write(byte* b) const final override;
+        
+        void reserve(N instructions, N data) {
+            Instructions.reserve(instructions);
+            Data.reserve(data);
+        }
+        
+        flat& emit(op);
+        
+        template <typename it>
+        flat& push(it begin, it end) {
+            N offset = Data.size();
+            Data.insert(Data.end(), begin, end);
+            return pushed(offset);
+        }
+        
+        flat& push(const byte* b, N size) {
+            return push(b, b + size);
+        }
+        
+        flat& push(bytes& b) {
+            return push(b.data(), b.size());
+        }
+        
+        // a push with the given op code, which need not be the 
+        // smallest but must have room for the size of the data. 
+        flat& push(op code, const byte* b, N size) {
+            N offset = Data.size();
+            Data.insert(Data.end(), b, b + size);
+            return add(code, offset, size);
+        }
+        
+        flat& push(N n) {
+            byte b[9];
+            return push(b, program::push::number(n, b));
+        }
+        
+        flat& append(const flat&);
+        
+        flat& append(const program& p) {
+            return read(p.compile());
+        }
+        
+    private:
+        N Length;
+        bool Valid;
+        
+        // turn the data after offset into a push instruction. 
+        flat& pushed(N offset);
+        
+        flat& add(op, N offset, N size);
+        
+        flat& read(const byte*, N size);
+        
+        flat& read(bytes& b) {
+            return read(b.data(), b.size());
+        }
+    };
+    
+}
+
+#endif
@@ -5,6 +5,7 @@
 #define ABSTRACTIONS_SCRIPT_FUNCTIONS
 
 #include "script.hpp"
+#include "flat.hpp"
 #include <abstractions/wallet/address.hpp>
 #include <abstractions/wallet/keys.hpp>
 
@@ -59,6 +60,10 @@ namespace abstractions::script {
         return op(program::OP_DUP);
     }
     
+    inline pointer<program> swap() {
+        return op(program::OP_SWAP);
+    }
+    
     inline pointer<program> to_alt() {
         return op(program::OP_TOALTSTACK);
     }
@@ -107,6 +112,79 @@ namespace abstractions::script {
         return op(program::OP_CHECKSIG);
     }
     
+    // The same builders, but writing into a flat program 
+    // instead of allocating a new tree node every time. 
+    
+    template <typename X>
+    inline flat& push(flat& f, X& x) {
+        return f.push(x.begin(), x.end());
+    }
+    
+    inline flat& push(flat& f, N n) {
+        return f.push(n);
+    }
+    
+    inline flat& dup(flat& f) {
+        return f.emit(program::OP_DUP);
+    }
+    
+    inline flat& swap(flat& f) {
+        return f.emit(program::OP_SWAP);
+    }
+    
+    inline flat& to_alt(flat& f) {
+        return f.emit(program::OP_TOALTSTACK);
+    }
+    
+    inline flat& from_alt(flat& f) {
+        return f.emit(program::OP_FROMALTSTACK);
+    }
+    
+    inline flat& cat(flat& f) {
+        return f.emit(program::OP_CAT);
+    }
+    
+    inline flat& concat(flat& f, N n) {
+        for (N i = 1; i < n; i++) cat(f);
+        return f;
+    }
+    
+    inline flat& split(flat& f, N n) {
+        return push(f, n).emit(program::OP_SPLIT);
+    }
+    
+    inline flat& rotate_bytes_left(flat& f, N n) {
+        return cat(split(f, n));
+    }
+    
+    inline flat& equal(flat& f) {
+        return f.emit(program::OP_EQUAL);
+    }
+    
+    inline flat& verify(flat& f) {
+        return f.emit(program::OP_VERIFY);
+    }
+    
+    inline flat& equal_verify(flat& f) {
+        return f.emit(program::OP_EQUALVERIFY);
+    }
+    
+    inline flat& bitcoin_hash(flat& f) {
+        return f.emit(program::OP_HASH256);
+    }
+    
+    inline flat& address_hash(flat& f) {
+        return f.emit(program::OP_HASH160);
+    }
+    
+    inline flat& sha256_hash(flat& f) {
+        return f.emit(program::OP_SHA256);
+    }
+    
+    inline flat& check_signature(flat& f) {
+        return f.emit(program::OP_CHECKSIG);
+    }
+    
 }
 
 #endif
@@ -0,0 +1,91 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_SCRIPT_INTERPRETER
+#define ABSTRACTIONS_SCRIPT_INTERPRETER
+
+#include <abstractions/abstractions.hpp>
+#include "machine.hpp"
+
+namespace abstractions::script {
+
+    // Runs compiled scripts directly, without converting them to
+    // another representation first. The stacks belong to the thread
+    // and are reused from one run to the next, so once they have grown
+    // large enough a run does not allocate.
+    struct interpreter {
+
+        // what the interpreter needs to know about the transaction
+        // that is being verified. The default checker knows nothing,
+        // so every signature fails.
+        struct checker {
+            virtual bool check_signature(bytes& signature, bytes& pubkey, bytes& script_code) const {
+                return false;
+            }
+
+            virtual bool check_locktime(int64_t) const {
+                return false;
+            }
+
+            virtual bool check_sequence(int64_t) const {
+                return false;
+            }
+
+            virtual ~checker() {}
+        };
+
+        // a transaction, which makes the checker for each of its inputs.
+        struct transaction {
+            virtual pointer<checker> input(index i, satoshi amount, uint32 flags) const = 0;
+
+            virtual ~transaction() {}
+        };
+
+        // the same bits as Satoshi's script flags.
+        enum flag : uint32 {
+            verify_none = 0,
+            verify_p2sh = 1,
+            verify_strict_encoding = 1 << 1,
+            verify_der_signatures = 1 << 2,
+            verify_low_s = 1 << 3,
+            verify_null_dummy = 1 << 4,
+            verify_push_only = 1 << 5,
+            verify_minimal_data = 1 << 6,
+            verify_clean_stack = 1 << 8,
+            verify_locktime = 1 << 9,
+            verify_sequence = 1 << 10,
+            verify_minimal_if = 1 << 13,
+            verify_null_fail = 1 << 14,
+            enable_fork_id = 1 << 16,
+
+            // the same as bitcoinconsensus_SCRIPT_FLAGS_VERIFY_ALL.
+            verify_all = verify_p2sh | verify_der_signatures | verify_null_dummy | verify_locktime | verify_sequence,
+
+            // what a transaction signed with the fork id is checked with.
+            verify_default = verify_all | verify_strict_encoding | enable_fork_id
+        };
+
+        // run without checking signatures.
+        interpreter() : Input{}, Checker{&none}, Flags{verify_none} {}
+
+        interpreter(const checker& c, uint32 flags = verify_all) : Input{}, Checker{&c}, Flags{flags} {}
+
+        // run an input of a transaction.
+        interpreter(const transaction& tx, index i, satoshi amount, uint32 flags = verify_default) :
+            Input{tx.input(i, amount, flags)}, Checker{Input.get()}, Flags{flags} {}
+
+        bool run(bytes& output, bytes& input) const;
+
+    private:
+        pointer<checker> Input;
+        const checker* Checker;
+        uint32 Flags;
+
+        static const checker none;
+    };
+
+    constexpr static machine::interface<interpreter, bytes&, const interpreter::transaction&> interpreter_is_machine{};
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_SCRIPT_OPTIMIZE
+#define ABSTRACTIONS_SCRIPT_OPTIMIZE
+
+#include "flat.hpp"
+
+namespace abstractions::script {
+    
+    // The result of a peephole pass over a program. The new program 
+    // leaves the same stack as the old one and fails in the same cases, 
+    // with any flags, except that it may use less of the stack and so 
+    // pass where the old one had too many elements. It is never longer. 
+    struct optimized {
+        flat Program;
+        
+        // length of the program before it was optimized. 
+        N Before;
+        
+        N after() const {
+            return Program.length();
+        }
+        
+        N saved() const {
+            return Before - after();
+        }
+    };
+    
+    // The rewrites are 
+    //   * OP_EQUAL OP_VERIFY and the like become OP_EQUALVERIFY. 
+    //   * a push followed by OP_DROP is removed, as are two pushes 
+    //     followed by OP_2DROP. 
+    //   * OP_CAT, OP_SPLIT, OP_SWAP, OP_ADD and OP_SUB on constants 
+    //     are done ahead of time. 
+    //   * OP_SWAP before a symmetric operation is removed. 
+    // Only pushes in their smallest form are rewritten, and the rest are 
+    // written just as they were, since a push in any other form fails if 
+    // minimal data is required. Constants that are worked out ahead of 
+    // time are written in their smallest form. OP_SPLIT followed by 
+    // OP_CAT is left alone unless the data is constant because OP_SPLIT 
+    // fails if the data is too short. 
+    optimized optimize(const program&);
+    
+}
+
+#endif
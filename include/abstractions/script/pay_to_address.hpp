@@ -5,6 +5,7 @@
 #define ABSTRACTIONS_SCRIPT_PAY_TO_ADDRESS
 
 #include "functions.hpp"
+#include "fixed.hpp"
 #include <abstractions/wallet/address.hpp>
 
 namespace abstractions::script {
@@ -35,7 +36,11 @@ namespace abstractions::script {
             o << Script;
         }
         
-        pay_to_address(bitcoin::address a) : Script{pay_to(a)->compile()}, Address{a} {}
+        byte* write(byte* b) const final override {
+            return std::copy(Script.begin(), Script.end(), b);
+        }
+        
+        pay_to_address(bitcoin::address a);
         pay_to_address(bytes& b) : Script{b}, Address{to(b)} {}
         
     };
@@ -48,6 +53,46 @@ namespace abstractions::script {
         return sequence({push(x), push(p)});
     }
     
+    namespace templates {
+        
+        constexpr fixed<25, 1> make_pay_to_address() {
+            fixed<25, 1> f{};
+            f.op(program::OP_DUP).op(program::OP_HASH160).slot(20).op(program::OP_EQUALVERIFY).op(program::OP_CHECKSIG);
+            return f;
+        }
+        
+        constexpr fixed<25, 1> pay_to_address = make_pay_to_address();
+        static_assert(pay_to_address.complete());
+        
+        inline byte* pay_to(byte* b, const bitcoin::address& a) {
+            pay_to_address.write(b);
+            pay_to_address.fill(b, 0, a);
+            return b + 25;
+        }
+        
+        inline bytes pay_to(const bitcoin::address& a) {
+            std::vector<byte> b(25);
+            pay_to(b.data(), a);
+            return b;
+        }
+        
+    }
+    
+    inline pay_to_address::pay_to_address(bitcoin::address a) : Script{templates::pay_to(a)}, Address{a} {}
+    
+    inline flat& pay_to(flat& f, bitcoin::address& a) {
+        dup(f);
+        address_hash(f);
+        push(f, a);
+        equal_verify(f);
+        return check_signature(f);
+    }
+    
+    inline flat& redeem_from_pay_to_address(flat& f, bitcoin::signature& x, bitcoin::pubkey& p) {
+        push(f, x);
+        return push(f, p);
+    }
+    
 }
 
 #endif
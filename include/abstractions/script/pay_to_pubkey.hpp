@@ -5,6 +5,7 @@
 #define ABSTRACTIONS_SCRIPT_PAY_TO_PUBKEY
 
 #include "functions.hpp"
+#include "fixed.hpp"
 #include <abstractions/wallet/address.hpp>
 #include <abstractions/crypto/secp256k1.hpp>
 
@@ -38,7 +39,11 @@ namespace abstractions::script {
             o << Script;
         }
         
-        pay_to_pubkey(pubkey p) : Script{pay_to(p)->compile()}, Pubkey{p} {}
+        byte* write(byte* b) const final override {
+            return std::copy(Script.begin(), Script.end(), b);
+        }
+        
+        pay_to_pubkey(pubkey p);
         pay_to_pubkey(bytes& b) : Script{b}, Pubkey{to(b)} {}
         
     };
@@ -51,10 +56,53 @@ namespace abstractions::script {
         return sequence({push(p), check_signature()});
     }
     
-    inline pointer<program> redeem_from_pay_to_address(bitcoin::signature& x) {
+    inline pointer<program> redeem_from_pay_to_pubkey(bitcoin::signature& x) {
         return sequence({push(x)});
     }
     
+    namespace templates {
+        
+        template <N size>
+        constexpr fixed<size + 2, 1> make_pay_to_pubkey() {
+            fixed<size + 2, 1> f{};
+            f.slot(size).op(program::OP_CHECKSIG);
+            return f;
+        }
+        
+        constexpr fixed<35, 1> pay_to_compressed_pubkey = make_pay_to_pubkey<33>();
+        constexpr fixed<67, 1> pay_to_uncompressed_pubkey = make_pay_to_pubkey<65>();
+        static_assert(pay_to_compressed_pubkey.complete());
+        static_assert(pay_to_uncompressed_pubkey.complete());
+        
+        inline bytes pay_to(const secp256k1::compressed_pubkey& p) {
+            std::vector<byte> b(35);
+            pay_to_compressed_pubkey.write(b.data());
+            pay_to_compressed_pubkey.fill(b.data(), 0, p);
+            return b;
+        }
+        
+        inline bytes pay_to(const secp256k1::uncompressed_pubkey& p) {
+            std::vector<byte> b(67);
+            pay_to_uncompressed_pubkey.write(b.data());
+            pay_to_uncompressed_pubkey.fill(b.data(), 0, p);
+            return b;
+        }
+        
+    }
+    
+    template <typename pubkey>
+    inline pay_to_pubkey<pubkey>::pay_to_pubkey(pubkey p) : Script{templates::pay_to(p)}, Pubkey{p} {}
+    
+    inline flat& pay_to(flat& f, secp256k1::compressed_pubkey& p) {
+        push(f, p);
+        return check_signature(f);
+    }
+    
+    inline flat& pay_to(flat& f, secp256k1::uncompressed_pubkey& p) {
+        push(f, p);
+        return check_signature(f);
+    }
+    
 }
 
 #endif
@@ -5,6 +5,7 @@
 #define ABSTRACTIONS_SCRIPT_POW
 
 #include "math.hpp"
+#include "fixed.hpp"
 #include <abstractions/work/work.hpp>
 #include <abstractions/crypto/hash/sha256.hpp>
 #include <abstractions/abstractions.hpp>
@@ -53,6 +54,26 @@ namespace abstractions::script {
     
     work::candidate unlock(pow_lock& l, pow_key& k);
     
+    namespace templates {
+        
+        // lock_by_pow up to and including the target, which is 
+        // everything with data in it. The rest is the same for 
+        // every pow lock. 
+        constexpr fixed<47, 2> make_pow_lock_prologue() {
+            fixed<47, 2> f{};
+            f.op(program::OP_SWAP).op(program::OP_TOALTSTACK).slot(32);
+            f.zeros(3);
+            f.op(program::OP_FROMALTSTACK).op(program::OP_DUP).op(program::OP_TOALTSTACK).slot(4);
+            return f;
+        }
+        
+        constexpr fixed<47, 2> pow_lock_prologue = make_pow_lock_prologue();
+        static_assert(pow_lock_prologue.complete());
+        
+        bytes lock_by_pow(const sha256::digest&, work::target);
+        
+    }
+    
     inline pointer<program> unlock_with_pow(bitcoin::signature& x, bitcoin::pubkey& p, uint64 nonce) {
         return sequence({push(x), push(p), push(nonce)});
     }
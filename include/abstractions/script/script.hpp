@@ -14,7 +14,17 @@ namespace abstractions::script {
     struct program {
         virtual N length() const = 0;
         virtual void write(ostream&) const = 0;
+        
+        // write the program to a buffer with room for at least 
+        // length() bytes and return the end of what was written. 
+        virtual byte* write(byte*) const = 0;
+        
         bytes compile() const;
+        
+        // compile into a buffer supplied by the caller. 
+        byte* compile(byte* b) const {
+            return write(b);
+        }
 
         operator bytes() const {
             return compile();
@@ -312,6 +322,10 @@ namespace abstractions::script {
 
     struct program::noop : public program {
         void write(ostream&) const final override {}
+        
+        byte* write(byte* b) const final override {
+            return b;
+        }
 
         N length() const final override {
             return 0;
@@ -350,15 +364,59 @@ namespace abstractions::script {
 
             o << Data;
         }
+        
+        byte* write(byte* b) const final override {
+            return encode(b, Data.data(), Data.size());
+        }
 
         N length() const final override {
-            N size = Data.size();
-            if (size == 0 || (size == 1 && Data[0] <= 16)) return 1;
+            return encoded_length(Data.data(), Data.size());
+        }
+        
+        // the smallest encoding of a push of the given data. 
+        static byte* encode(byte* b, const byte* data, N size) {
+            if (size == 0 || (size == 1 && data[0] == 0)) {
+                *b = program::OP_0;
+                return b + 1;
+            }
+
+            if (size == 1 && data[0] <= 16) {
+                *b = byte(data[0] + 0x50);
+                return b + 1;
+            }
+
+            if (size > 0xffff) {
+                *b++ = program::OP_PUSHDATA4;
+                for (int i = 0; i < 4; i++) *b++ = byte(size >> (8 * i));
+            } else if (size > 0xff) {
+                *b++ = program::OP_PUSHDATA2;
+                for (int i = 0; i < 2; i++) *b++ = byte(size >> (8 * i));
+            } else if (size > 75) {
+                *b++ = program::OP_PUSHDATA1;
+                *b++ = byte(size);
+            } else {
+                *b++ = byte(size);
+            }
+
+            return std::copy(data, data + size, b);
+        }
+        
+        static N encoded_length(const byte* data, N size) {
+            if (size == 0 || (size == 1 && data[0] <= 16)) return 1;
             if (size > 0xffff) return size + 5;
             if (size > 0xff) return size + 3;
             if (size > 75) return size + 2;
             return size + 1;
         }
+        
+        // write a number as a script number, which is little endian with 
+        // the sign in the last bit, and return the number of bytes written. 
+        static N number(N n, byte* b) {
+            N size = 0;
+            for (; n > 0; n >>= 8) b[size++] = byte(n);
+            if (size > 0 && (b[size - 1] & 0x80)) b[size++] = 0;
+            return size;
+        }
 
         push(bytes data) : Data{data} {}
     };
@@ -368,6 +426,11 @@ namespace abstractions::script {
         void write(ostream& o) const final override {
             o << byte(OpCode);
         }
+        
+        byte* write(byte* b) const final override {
+            *b = byte(OpCode);
+            return b + 1;
+        }
 
         N length() const final override {
             return 1;
@@ -381,6 +444,11 @@ namespace abstractions::script {
         void write(ostream& o) const final override {
             for (op code: String) o << byte(code);
         }
+        
+        byte* write(byte* b) const final override {
+            for (op code: String) *b++ = byte(code);
+            return b;
+        }
 
         N length() const final override {
             return String.size();
@@ -390,13 +458,31 @@ namespace abstractions::script {
     };
 
     struct program::sequence : public list<pointer<program>>, public program {
-        using list<pointer<program>>::list;
+        sequence(std::vector<pointer<program>> v) : list<pointer<program>>(v), Length{measure(v)} {}
+        
         void write(ostream& o) const final override {
             for (pointer<program> p : *this) p->write(o);
         }
+        
+        byte* write(byte* b) const final override {
+            for (const pointer<program>& p : *this) b = p->write(b);
+            return b;
+        }
 
+        // The length is computed when the sequence is made, so that nested 
+        // sequences are not walked again every time they are measured and 
+        // a sequence can be compiled from many threads at once. 
         N length() const final override {
-            return data::fold([](uint len, pointer<program> p)->uint{return len + p->length();}, 0, *this);
+            return Length;
+        }
+        
+    private:
+        N Length;
+        
+        static N measure(const std::vector<pointer<program>>& v) {
+            N len = 0;
+            for (const pointer<program>& p : v) len += p->length();
+            return len;
         }
     };
 
@@ -406,6 +492,16 @@ namespace abstractions::script {
         void write(ostream& o) const final override {
             for (int i = 0; i < Repetitions; i++) Repeated->write(o);
         }
+        
+        byte* write(byte* b) const final override {
+            if (Repetitions == 0) return b;
+            byte* first = b;
+            b = Repeated->write(b);
+            // every repetition is the same, so copy the first one. 
+            N size = b - first;
+            for (N i = 1; i < Repetitions; i++) b = std::copy(first, first + size, b);
+            return b;
+        }
 
         N length() const final override {
             return Repetitions * Repeated->length();
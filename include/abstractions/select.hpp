@@ -0,0 +1,88 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_SELECT
+#define ABSTRACTIONS_SELECT
+
+#include <abstractions/abstractions.hpp>
+
+// Coin selection: which outputs to spend in order to pay a given amount.
+// Every input costs the fee for its size, so an output is worth its
+// effective value, which is its value less that fee. Outputs which are
+// worth nothing are never chosen.
+namespace abstractions::select {
+
+    struct options {
+        // satoshis per 1000 bytes now and in the long run.
+        satoshi FeeRate;
+        satoshi LongTermFeeRate;
+
+        // the expected size of a transaction with no inputs,
+        // of one input, and of a change output.
+        N BaseSize;
+        N InputSize;
+        N ChangeSize;
+
+        // smaller change than this is added to the fee instead.
+        satoshi Dust;
+
+        satoshi fee(N size) const {
+            return FeeRate * size / 1000;
+        }
+
+        // the fee for a transaction without change. Each input is charged
+        // on its own, since that is what its effective value assumes.
+        satoshi fee_for_inputs(N inputs) const {
+            return fee(BaseSize) + inputs * fee(InputSize);
+        }
+
+        // the cost of making change and of spending it later.
+        satoshi cost_of_change() const {
+            return fee(ChangeSize) + LongTermFeeRate * InputSize / 1000;
+        }
+    };
+
+    // a pay to address input and output.
+    const options standard{1000, 1000, 10, 148, 34, 546};
+
+    struct selection {
+        // positions of the chosen outputs.
+        std::vector<N> Inputs;
+
+        satoshi Value;
+        satoshi Fee;
+        satoshi Change;
+
+        // what the selection costs compared to an ideal one: the fees for the
+        // inputs beyond what they would cost in the long run plus either the
+        // cost of change or the excess which goes to the miner.
+        int64_t Waste;
+
+        selection() : Inputs{}, Value{0}, Fee{0}, Change{0}, Waste{0} {}
+
+        bool valid() const {
+            return !Inputs.empty();
+        }
+    };
+
+    // Values may be given in any order, but values given from most to least
+    // are not sorted again, so a store that keeps its outputs in that order
+    // can be selected from in linear time.
+
+    // search for a set of outputs that pays the amount
+    // without change. It may not find one.
+    selection branch_and_bound(const std::vector<satoshi>& values, satoshi amount, const options& = standard);
+
+    // spend the largest outputs first.
+    selection largest_first(const std::vector<satoshi>& values, satoshi amount, const options& = standard);
+
+    // look randomly for a set of outputs that is as close
+    // to the amount as possible, as Satoshi's wallet did.
+    selection knapsack(const std::vector<satoshi>& values, satoshi amount, const options& = standard, uint64 seed = 0);
+
+    // try each of the above and return the selection with the least waste.
+    selection coins(const std::vector<satoshi>& values, satoshi amount, const options& = standard);
+
+}
+
+#endif
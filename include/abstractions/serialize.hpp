@@ -0,0 +1,188 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_SERIALIZE
+#define ABSTRACTIONS_SERIALIZE
+
+#include <abstractions/abstractions.hpp>
+
+#include <cstring>
+
+#ifdef _WIN32
+namespace abstractions::serialize {
+    // there is no writev, but the pieces can still be written in turn.
+    struct iovec {
+        void* iov_base;
+        size_t iov_len;
+    };
+}
+#else
+#include <sys/uio.h>
+#endif
+
+// Serialization of transaction representations. The size is computed
+// first so that the buffer is allocated once, and scripts and hashes
+// are copied whole rather than a field at a time. The functions work
+// with anything that has the members of the representations in
+// abstractions/transaction.hpp.
+namespace abstractions::serialize {
+
+    inline N var_int_size(N x) {
+        if (x < 0xfd) return 1;
+        if (x <= 0xffff) return 3;
+        if (x <= 0xffffffff) return 5;
+        return 9;
+    }
+
+    inline byte* write_little(byte* b, uint64 x, N size) {
+        for (N i = 0; i < size; i++) b[i] = byte(x >> (8 * i));
+        return b + size;
+    }
+
+    inline byte* write_var_int(byte* b, N x) {
+        if (x < 0xfd) return write_little(b, x, 1);
+        if (x <= 0xffff) return write_little(write_little(b, 0xfd, 1), x, 2);
+        if (x <= 0xffffffff) return write_little(write_little(b, 0xfe, 1), x, 4);
+        return write_little(write_little(b, 0xff, 1), x, 8);
+    }
+
+    template <typename X>
+    inline N range_size(const X& x) {
+        return x.end() - x.begin();
+    }
+
+    template <typename X>
+    inline byte* write_range(byte* b, const X& x) {
+        N size = range_size(x);
+        if (size != 0) std::memcpy(b, &*x.begin(), size);
+        return b + size;
+    }
+
+    template <typename script>
+    inline N script_size(const script& s) {
+        N size = range_size(s);
+        return var_int_size(size) + size;
+    }
+
+    template <typename point>
+    inline N outpoint_size(const point& p) {
+        return range_size(p.Reference) + 4;
+    }
+
+    template <typename in>
+    inline N input_size(const in& i) {
+        return outpoint_size(i.Outpoint) + script_size(i.ScriptSignature) + 4;
+    }
+
+    template <typename out>
+    inline N output_size(const out& o) {
+        return 8 + script_size(o.ScriptPubKey);
+    }
+
+    template <typename tx>
+    N size(const tx& t) {
+        N size = 8 + var_int_size(t.Inputs.size()) + var_int_size(t.Outputs.size());
+        for (const auto& i : t.Inputs) size += input_size(i);
+        for (const auto& o : t.Outputs) size += output_size(o);
+        return size;
+    }
+
+    // write into a buffer of at least size(t) bytes and
+    // return the position after the end.
+    template <typename tx>
+    byte* write(byte* b, const tx& t) {
+        b = write_little(b, uint32(t.Version), 4);
+        b = write_var_int(b, t.Inputs.size());
+        for (const auto& i : t.Inputs) {
+            b = write_range(b, i.Outpoint.Reference);
+            b = write_little(b, i.Outpoint.Index, 4);
+            b = write_var_int(b, range_size(i.ScriptSignature));
+            b = write_range(b, i.ScriptSignature);
+            b = write_little(b, i.Sequence, 4);
+        }
+        b = write_var_int(b, t.Outputs.size());
+        for (const auto& o : t.Outputs) {
+            b = write_little(b, o.Value, 8);
+            b = write_var_int(b, range_size(o.ScriptPubKey));
+            b = write_range(b, o.ScriptPubKey);
+        }
+        return write_little(b, t.Locktime, 4);
+    }
+
+    template <typename tx>
+    std::vector<byte> write(const tx& t) {
+        std::vector<byte> b(size(t));
+        write(b.data(), t);
+        return b;
+    }
+
+    // A transaction written as a list of pieces for writev. Scripts
+    // are not copied; their pieces refer to the representation, which
+    // must outlive the gather. Everything else is in Fixed.
+    struct gather {
+        std::vector<byte> Fixed;
+        std::vector<iovec> Pieces;
+
+        template <typename tx>
+        explicit gather(const tx& t);
+
+        // pieces point into Fixed, so it cannot be copied.
+        gather(const gather&) = delete;
+        gather& operator=(const gather&) = delete;
+
+        N size() const {
+            N size = 0;
+            for (const iovec& v : Pieces) size += v.iov_len;
+            return size;
+        }
+
+    private:
+        byte* Start;
+
+        // end the current run of fixed bytes at b.
+        void fixed(byte* b) {
+            if (b != Start) Pieces.push_back(iovec{Start, N(b - Start)});
+            Start = b;
+        }
+
+        template <typename script>
+        byte* refer(byte* b, const script& s) {
+            N size = range_size(s);
+            b = write_var_int(b, size);
+            if (size == 0) return b;
+            fixed(b);
+            Pieces.push_back(iovec{const_cast<byte*>(&*s.begin()), size});
+            return b;
+        }
+    };
+
+    template <typename tx>
+    gather::gather(const tx& t) : Fixed{}, Pieces{}, Start{nullptr} {
+        N scripts = 0;
+        for (const auto& i : t.Inputs) scripts += range_size(i.ScriptSignature);
+        for (const auto& o : t.Outputs) scripts += range_size(o.ScriptPubKey);
+
+        // Fixed is never resized after this, so pieces may point into it.
+        Fixed.resize(serialize::size(t) - scripts);
+        Pieces.reserve(2 * (t.Inputs.size() + t.Outputs.size()) + 1);
+        byte* b = Start = Fixed.data();
+
+        b = write_little(b, uint32(t.Version), 4);
+        b = write_var_int(b, t.Inputs.size());
+        for (const auto& i : t.Inputs) {
+            b = write_range(b, i.Outpoint.Reference);
+            b = write_little(b, i.Outpoint.Index, 4);
+            b = refer(b, i.ScriptSignature);
+            b = write_little(b, i.Sequence, 4);
+        }
+        b = write_var_int(b, t.Outputs.size());
+        for (const auto& o : t.Outputs) {
+            b = write_little(b, o.Value, 8);
+            b = refer(b, o.ScriptPubKey);
+        }
+        fixed(write_little(b, t.Locktime, 4));
+    }
+
+}
+
+#endif
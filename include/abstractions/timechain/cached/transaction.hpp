@@ -1,41 +1,49 @@
-#ifndef ABSTRACTIONS_BITCOIN_CACHED_TRANSACTION_HPP
-#define ABSTRACTIONS_BITCOIN_CACHED_TRANSACTION_HPP
-
-#include <abstractions/bitcoin/transaction.hpp>
-
-namespace abstractions 
-{
-    
-    namespace transaction {
-        
-        // A header that caches the result of calculating its hash. 
-        template <typename tx, typename in, typename out, typename digest>
-        struct cached {
-            tx Transaction;
-            
-            slice<out> outputs(tx t) const {
-                return outputs(Transaction);
-            }
-            
-            slice<in> inputs(tx t) const {
-                return inputs(Transaction);
-            }
-            
-            const digest hash() const {
-                if (Digest == digest{}) Digest = hash(Transaction);
-                
-                return Digest;
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_TIMECHAIN_CACHED_TRANSACTION
+#define ABSTRACTIONS_TIMECHAIN_CACHED_TRANSACTION
+
+#include <abstractions/timechain/transaction.hpp>
+
+namespace abstractions::timechain::transaction {
+
+    // A transaction that caches its id. The id is calculated the
+    // first time it is needed, or given when the transaction is
+    // built by something that already knows it.
+    template <typename tx, typename digest>
+    struct cached {
+
+        cached(const tx& t) : Transaction{t}, Digest{}, Hashed{false} {}
+        cached(const tx& t, const digest& d) : Transaction{t}, Digest{d}, Hashed{true} {}
+        cached() : Transaction{}, Digest{}, Hashed{false} {}
+
+        const tx& transaction() const {
+            return Transaction;
+        }
+
+        operator const tx&() const {
+            return Transaction;
+        }
+
+        bool valid() const {
+            return Transaction.valid();
+        }
+
+        const digest& id() const {
+            if (!Hashed) {
+                Digest = Transaction.id();
+                Hashed = true;
             }
-            
-            cached(tx t) : Transaction{t}, Digest{} {}
-            
-        private:
-            mutable digest Digest;
-        };
-        
-    } 
+            return Digest;
+        }
+
+    private:
+        tx Transaction;
+        mutable digest Digest;
+        mutable bool Hashed;
+    };
 
 }
 
 #endif
-
@@ -34,6 +34,13 @@ namespace abstractions::timechain {
                 return h.target();
             }
             
+            // whether the header's proof of work meets its target. The
+            // target only changes between difficulty periods, so the 
+            // headers in one period can share a threshold. 
+            bool satisfied(header& h, const work::threshold& t) const {
+                return t.below(h.work());
+            }
+            
         };
     
     }
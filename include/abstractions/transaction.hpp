@@ -10,8 +10,58 @@
 
 namespace abstractions {
     
+    // Bytes that can only be replaced all at once, by assignment, so 
+    // that whatever was read from them when they were made stays true. 
+    struct serialized : public std::vector<byte> {
+        serialized() : std::vector<byte>{} {}
+        serialized(bytes& b) : std::vector<byte>{b} {}
+        explicit serialized(N size) : std::vector<byte>(size) {}
+        
+        const byte& operator[](N i) const {
+            return std::vector<byte>::operator[](i);
+        }
+        
+        const byte& at(N i) const {
+            return std::vector<byte>::at(i);
+        }
+        
+        const byte& front() const {
+            return std::vector<byte>::front();
+        }
+        
+        const byte& back() const {
+            return std::vector<byte>::back();
+        }
+        
+        const byte* data() const {
+            return std::vector<byte>::data();
+        }
+        
+        const_iterator begin() const {
+            return std::vector<byte>::begin();
+        }
+        
+        const_iterator end() const {
+            return std::vector<byte>::end();
+        }
+        
+    private:
+        using std::vector<byte>::assign;
+        using std::vector<byte>::clear;
+        using std::vector<byte>::insert;
+        using std::vector<byte>::emplace;
+        using std::vector<byte>::erase;
+        using std::vector<byte>::push_back;
+        using std::vector<byte>::emplace_back;
+        using std::vector<byte>::pop_back;
+        using std::vector<byte>::resize;
+        using std::vector<byte>::swap;
+        using std::vector<byte>::rbegin;
+        using std::vector<byte>::rend;
+    };
+    
     template <typename ops> 
-    struct output : public std::vector<byte> {
+    struct output : public serialized {
         class representation {
             bool Valid;
         public:
@@ -37,29 +87,40 @@ namespace abstractions {
         };
         
         bool valid() const {
-            return representation{*this}.Valid;
+            return read().Valid;
         }
         
         satoshi value() const {
-            return representation{*this}.Value;
+            return read().Value;
         }
         
         const slice<byte> script() const;
         
-        output() : std::vector<byte>{} {}
-        output(bytes& b) : std::vector<byte>{b} {}
+        output() : serialized{}, Representation{} {}
+        output(bytes& b) : serialized{b}, Representation{*this} {}
         output(const representation&) noexcept;
         
         output& operator=(const output& o) {
             std::vector<byte>::operator=(static_cast<bytes&>(o));
+            Representation = o.Representation;
             return *this;
         }
         
+        // the output is read when it is made, so this 
+        // is safe to call from many threads at once. 
+        const representation& read() const {
+            return Representation;
+        }
+        
+    private:
+        representation Representation;
+    public:
+        
         constexpr static timechain::output::interface<output<ops>::representation, ops> representation_is_output{};
     };
     
     template <typename txid>
-    struct outpoint : public std::vector<byte> {
+    struct outpoint : public serialized {
         using tx_index = abstractions::index;
         
         struct representation {
@@ -87,23 +148,32 @@ namespace abstractions {
         };
         
         bool valid() const {
-            return representation{*this}.Valid;
+            return read().Valid;
         }
         
-        outpoint() : std::vector<byte>{} {}
-        outpoint(bytes& b) : std::vector<byte>{b} {}
+        outpoint() : serialized{}, Representation{} {}
+        outpoint(bytes& b) : serialized{b}, Representation{*this} {}
         outpoint(const representation&) noexcept;
         
         outpoint& operator=(const outpoint& o) {
             std::vector<byte>::operator=(static_cast<bytes&>(o));
+            Representation = o.Representation;
             return *this;
         }
         
+        const representation& read() const {
+            return Representation;
+        }
+        
+    private:
+        representation Representation;
+    public:
+        
         constexpr static timechain::outpoint::interface<outpoint::representation, txid&, tx_index> is_outpoint{};
     };
     
     template <typename txid, typename ops>
-    struct input : public std::vector<byte> {
+    struct input : public serialized {
         using point = typename outpoint<txid>::representation;
         
         struct representation {
@@ -133,21 +203,29 @@ namespace abstractions {
         };
         
         bool valid() const {
-            return representation{*this}.Valid;
+            return read().Valid;
         }
         
-        input() : std::vector<byte>{} {}
-        input(bytes& b) : std::vector<byte>{b} {}
+        input() : serialized{}, Representation{} {}
+        input(bytes& b) : serialized{b}, Representation{*this} {}
         input(const representation&) noexcept;
         
         input& operator=(const input& i) {
             std::vector<byte>::operator=(static_cast<bytes&>(i));
+            Representation = i.Representation;
             return *this;
         }
+        
+        const representation& read() const {
+            return Representation;
+        }
+        
+    private:
+        representation Representation;
     };
     
     template <typename in, typename out>
-    struct transaction : public std::vector<byte> {
+    struct transaction : public serialized {
         
         struct representation {
             bool Valid;
@@ -190,21 +268,32 @@ namespace abstractions {
         
         };
         
-        transaction() : std::vector<byte>{} {}
-        transaction(bytes& b) : std::vector<byte>{b} {}
+        transaction() : serialized{}, Representation{} {}
+        transaction(bytes& b) : serialized{b}, Representation{*this} {}
         transaction(const representation&) noexcept;
         transaction(vector<in> i, vector<out> o) : transaction{representation{i, o}} {}
         transaction(vector<in> i, vector<out> o, uint32 l) : transaction{representation{i, o, l}} {}
         
         transaction& operator=(const transaction& t) {
             std::vector<byte>::operator=(static_cast<bytes&>(t));
+            Representation = t.Representation;
             return *this;
         }
         
         bool valid() const {
-            return representation{*this}.Valid;
+            return read().Valid;
         }
         
+        // the transaction is read when it is made and 
+        // not again unless another one is assigned to it. 
+        const representation& read() const {
+            return Representation;
+        }
+        
+    private:
+        representation Representation;
+    public:
+        
         constexpr static timechain::transaction::interface<transaction::representation, in, out> is_tx{};
     };
     
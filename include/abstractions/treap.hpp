@@ -0,0 +1,130 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_TREAP
+#define ABSTRACTIONS_TREAP
+
+#include <abstractions/abstractions.hpp>
+
+namespace abstractions {
+
+    // A persistent treap: a search tree kept in the order given by less
+    // and balanced by a priority which comes from the hash of each key.
+    // As with the hamt, a change makes a new tree which shares all but
+    // the path to the change with the old one.
+    template <typename K, typename V, typename less, typename hash>
+    struct treap {
+        treap() : Root{}, Size{0} {}
+
+        N size() const {
+            return Size;
+        }
+
+        bool empty() const {
+            return Size == 0;
+        }
+
+        // valid for as long as this version of the tree exists.
+        const V* find(const K& k) const {
+            const node* n = Root.get();
+            while (n != nullptr) {
+                if (less{}(k, n->Key)) n = n->Left.get();
+                else if (less{}(n->Key, k)) n = n->Right.get();
+                else return &n->Value;
+            }
+            return nullptr;
+        }
+
+        bool contains(const K& k) const {
+            return find(k) != nullptr;
+        }
+
+        // add a value or replace the value that is there.
+        treap insert(const K& k, const V& v) const {
+            bool added = false;
+            return treap{insert(Root, k, v, priority(k), added), Size + (added ? 1 : 0)};
+        }
+
+        treap remove(const K& k) const {
+            if (!contains(k)) return *this;
+            return treap{remove(Root, k), Size - 1};
+        }
+
+        // call f with every key and value, in order.
+        template <typename function>
+        void for_each(function f) const {
+            if (Root != nullptr) for_each(*Root, f);
+        }
+
+    private:
+        struct node {
+            K Key;
+            V Value;
+            N Priority;
+            pointer<const node> Left;
+            pointer<const node> Right;
+        };
+
+        pointer<const node> Root;
+        N Size;
+
+        treap(pointer<const node> r, N size) : Root{r}, Size{size} {}
+
+        // the hash is mixed so that keys which hash to
+        // nearby numbers do not make the tree lopsided.
+        static N priority(const K& k) {
+            N x = hash{}(k) * 0x9e3779b97f4a7c15;
+            return x ^ (x >> 29);
+        }
+
+        static pointer<const node> make(const node& n, pointer<const node> left, pointer<const node> right) {
+            return std::make_shared<const node>(node{n.Key, n.Value, n.Priority, left, right});
+        }
+
+        static pointer<const node> insert(const pointer<const node>& n, const K& k, const V& v, N p, bool& added) {
+            if (n == nullptr) {
+                added = true;
+                return std::make_shared<const node>(node{k, v, p, nullptr, nullptr});
+            }
+
+            // the new node is rotated up for as long as it has a higher priority.
+            if (less{}(k, n->Key)) {
+                pointer<const node> l = insert(n->Left, k, v, p, added);
+                if (l->Priority > n->Priority) return make(*l, l->Left, make(*n, l->Right, n->Right));
+                return make(*n, l, n->Right);
+            }
+
+            if (less{}(n->Key, k)) {
+                pointer<const node> r = insert(n->Right, k, v, p, added);
+                if (r->Priority > n->Priority) return make(*r, make(*n, n->Left, r->Left), r->Right);
+                return make(*n, n->Left, r);
+            }
+
+            return std::make_shared<const node>(node{k, v, n->Priority, n->Left, n->Right});
+        }
+
+        static pointer<const node> remove(const pointer<const node>& n, const K& k) {
+            if (less{}(k, n->Key)) return make(*n, remove(n->Left, k), n->Right);
+            if (less{}(n->Key, k)) return make(*n, n->Left, remove(n->Right, k));
+            return merge(n->Left, n->Right);
+        }
+
+        // join two trees where every key in a is less than every key in b.
+        static pointer<const node> merge(const pointer<const node>& a, const pointer<const node>& b) {
+            if (a == nullptr) return b;
+            if (b == nullptr) return a;
+            if (a->Priority > b->Priority) return make(*a, a->Left, merge(a->Right, b));
+            return make(*b, merge(a, b->Left), b->Right);
+        }
+
+        template <typename function>
+        static void for_each(const node& n, function& f) {
+            if (n.Left != nullptr) for_each(*n.Left, f);
+            f(n.Key, n.Value);
+            if (n.Right != nullptr) for_each(*n.Right, f);
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,214 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_UTXO
+#define ABSTRACTIONS_UTXO
+
+#include <abstractions/abstractions.hpp>
+#include <abstractions/hamt.hpp>
+#include <abstractions/treap.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace abstractions {
+
+    // the first bytes of a digest are as good a hash as any.
+    template <typename digest>
+    struct digest_hash {
+        N operator()(const digest& d) const {
+            uint64 x = 0;
+            std::memcpy(&x, &*d.begin(), std::min(N(d.end() - d.begin()), N(8)));
+            return x;
+        }
+    };
+
+    template <typename digest>
+    struct digest_equal {
+        bool operator()(const digest& a, const digest& b) const {
+            return a == b;
+        }
+    };
+
+    template <typename point>
+    struct outpoint_hash {
+        N operator()(const point& p) const {
+            return digest_hash<decltype(p.Reference)>{}(p.Reference) ^ (uint64(p.Index) * 0x9e3779b97f4a7c15);
+        }
+    };
+
+    template <typename point>
+    struct outpoint_equal {
+        bool operator()(const point& a, const point& b) const {
+            return a.Index == b.Index && a.Reference == b.Reference;
+        }
+    };
+
+    // outpoints in no particular order but always the same one.
+    template <typename point>
+    struct outpoint_less {
+        bool operator()(const point& a, const point& b) const {
+            if (a.Index != b.Index) return a.Index < b.Index;
+            return std::lexicographical_compare(a.Reference.begin(), a.Reference.end(), b.Reference.begin(), b.Reference.end());
+        }
+    };
+
+    // Unspent outputs indexed by outpoint, by tag and by value. The
+    // indices are persistent, so a copy costs nothing and a change costs
+    // time logarithmic in the number of outputs while leaving earlier
+    // copies as they were. Totals are kept as outputs come and go, so
+    // balances are known without looking at the outputs.
+    template <typename point, typename out, typename tag,
+        typename point_hash = outpoint_hash<point>,
+        typename point_equal = outpoint_equal<point>,
+        typename tag_hash = digest_hash<tag>,
+        typename tag_equal = digest_equal<tag>,
+        typename point_less = outpoint_less<point>>
+    struct utxo {
+        struct entry {
+            point Point;
+            out Output;
+            tag Tag;
+            bool Confirmed;
+        };
+
+        utxo() : Entries{}, Tags{}, Values{}, Value{0}, Confirmed{0} {}
+
+        N size() const {
+            return Entries.size();
+        }
+
+        // the total value of all outputs.
+        satoshi value() const {
+            return Value;
+        }
+
+        satoshi confirmed() const {
+            return Confirmed;
+        }
+
+        satoshi unconfirmed() const {
+            return Value - Confirmed;
+        }
+
+        // the total value of the outputs with a given tag.
+        satoshi value(const tag& t) const {
+            const tagged* x = Tags.find(t);
+            return x == nullptr ? 0 : x->Value;
+        }
+
+        // valid for as long as this copy is not changed.
+        const entry* find(const point& p) const {
+            return Entries.find(p);
+        }
+
+        bool contains(const point& p) const {
+            return Entries.contains(p);
+        }
+
+        // false if the outpoint is already there.
+        bool insert(const point& p, const out& o, const tag& t, bool confirmed = true) {
+            if (Entries.contains(p)) return false;
+            Entries = Entries.insert(p, entry{p, o, t, confirmed});
+            Value += o.Value;
+            if (confirmed) Confirmed += o.Value;
+
+            const tagged* x = Tags.find(t);
+            tagged next = x == nullptr ? tagged{0, {}} : *x;
+            next.Value += o.Value;
+            next.Points = next.Points.insert(p, true);
+            Tags = Tags.insert(t, next);
+            Values = Values.insert(valued{o.Value, p}, true);
+            return true;
+        }
+
+        // false if the outpoint is not there or is already confirmed.
+        bool confirm(const point& p) {
+            const entry* e = Entries.find(p);
+            if (e == nullptr || e->Confirmed) return false;
+            entry next = *e;
+            next.Confirmed = true;
+            Confirmed += next.Output.Value;
+            Entries = Entries.insert(p, next);
+            return true;
+        }
+
+        // false if the outpoint was not there.
+        bool remove(const point& p) {
+            const entry* e = Entries.find(p);
+            if (e == nullptr) return false;
+            Value -= e->Output.Value;
+            if (e->Confirmed) Confirmed -= e->Output.Value;
+
+            tagged next = *Tags.find(e->Tag);
+            next.Value -= e->Output.Value;
+            next.Points = next.Points.remove(p);
+            Tags = next.Points.empty() ? Tags.remove(e->Tag) : Tags.insert(e->Tag, next);
+
+            Values = Values.remove(valued{e->Output.Value, p});
+            Entries = Entries.remove(p);
+            return true;
+        }
+
+        // call f on every output with the given tag.
+        template <typename function>
+        void for_each(const tag& t, function f) const {
+            const tagged* x = Tags.find(t);
+            if (x == nullptr) return;
+            x->Points.for_each([this, &f](const point& p, bool) {
+                f(*Entries.find(p));
+            });
+        }
+
+        // call f on every output, in no particular order.
+        template <typename function>
+        void for_each(function f) const {
+            Entries.for_each([&f](const point&, const entry& e) {
+                f(e);
+            });
+        }
+
+        // call f on every output, the most valuable first.
+        template <typename function>
+        void for_each_by_value(function f) const {
+            Values.for_each([this, &f](const valued& v, bool) {
+                f(*Entries.find(v.Point));
+            });
+        }
+
+    private:
+        // the outputs with a tag and their total value.
+        struct tagged {
+            satoshi Value;
+            hamt<point, bool, point_hash, point_equal> Points;
+        };
+
+        // an output in the index by value.
+        struct valued {
+            satoshi Value;
+            point Point;
+        };
+
+        struct more_valuable {
+            bool operator()(const valued& a, const valued& b) const {
+                if (a.Value != b.Value) return a.Value > b.Value;
+                return point_less{}(a.Point, b.Point);
+            }
+        };
+
+        struct valued_hash {
+            N operator()(const valued& v) const {
+                return point_hash{}(v.Point);
+            }
+        };
+
+        hamt<point, entry, point_hash, point_equal> Entries;
+        hamt<tag, tagged, tag_hash, tag_equal> Tags;
+        treap<valued, bool, more_valuable, valued_hash> Values;
+        satoshi Value;
+        satoshi Confirmed;
+    };
+
+}
+
+#endif
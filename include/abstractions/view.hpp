@@ -0,0 +1,195 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_VIEW
+#define ABSTRACTIONS_VIEW
+
+#include <abstractions/abstractions.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace abstractions::view {
+
+    // position of an input or output and of the script inside it.
+    struct position {
+        uint32 Offset;
+        uint32 Script;
+        uint32 ScriptSize;
+    };
+
+    // an output in a serialized transaction.
+    struct output {
+        satoshi Value;
+        slice<byte> Script;
+
+        satoshi value() const {
+            return Value;
+        }
+
+        slice<byte> script() const {
+            return Script;
+        }
+    };
+
+    // an input in a serialized transaction.
+    struct input {
+        slice<byte> Outpoint;
+        slice<byte> Script;
+        uint32 Sequence;
+
+        slice<byte> script() const {
+            return Script;
+        }
+
+        uint32 sequence() const {
+            return Sequence;
+        }
+    };
+
+    // A serialized transaction which has been read once to find where
+    // everything is. Nothing is copied; the views returned refer to the
+    // bytes that were given, which must outlive the transaction.
+    struct transaction {
+
+        // the slice may continue past the end of the transaction, as
+        // it does in a block; size() says where the transaction ends.
+        explicit transaction(slice<byte>);
+        explicit transaction(std::vector<byte>& b) : transaction{slice<byte>::make(b)} {}
+
+        bool valid() const {
+            return Valid;
+        }
+
+        // the size of the serialized transaction.
+        N size() const {
+            return Size;
+        }
+
+        int32 version() const;
+        uint32 locktime() const;
+
+        N inputs() const {
+            return Inputs.size();
+        }
+
+        N outputs() const {
+            return Outputs.size();
+        }
+
+        view::input input(N) const;
+        view::output output(N) const;
+
+        // all of the serialized outputs, one after another.
+        slice<byte> serialized_outputs() const;
+
+    private:
+        slice<byte> Data;
+        bool Valid;
+        N Size;
+
+        std::vector<position> Inputs;
+        std::vector<position> Outputs;
+    };
+
+    // A serialized block, read in one pass. The inputs and outputs of
+    // all its transactions are kept in two tables in the order in which
+    // they appear, and the values of the outputs are decoded as well.
+    struct block {
+        explicit block(slice<byte>);
+        explicit block(std::vector<byte>& b) : block{slice<byte>::make(b)} {}
+
+        bool valid() const {
+            return Valid;
+        }
+
+        slice<byte> header() const;
+
+        N transactions() const {
+            return Transactions.size() == 0 ? 0 : Transactions.size() - 1;
+        }
+
+        // the serialized transaction.
+        slice<byte> transaction(N) const;
+
+        // positions in the input and output tables of
+        // the first input and output of a transaction.
+        N first_input(N t) const {
+            return FirstInputs[t];
+        }
+
+        N first_output(N t) const {
+            return FirstOutputs[t];
+        }
+
+        N inputs() const {
+            return Inputs.size();
+        }
+
+        N outputs() const {
+            return Outputs.size();
+        }
+
+        view::input input(N) const;
+        view::output output(N) const;
+
+        satoshi value(N o) const {
+            return Values[o];
+        }
+
+    private:
+        slice<byte> Data;
+        bool Valid;
+
+        // where each transaction begins, and then the end of the last one.
+        std::vector<uint32> Transactions;
+        std::vector<uint32> FirstInputs;
+        std::vector<uint32> FirstOutputs;
+
+        std::vector<position> Inputs;
+        std::vector<position> Outputs;
+        std::vector<satoshi> Values;
+    };
+
+    // A file of blocks in the format of blk*.dat, mapped into memory.
+    // Each block is preceded by the network magic and its size. Blocks
+    // and the transactions in them are views into the mapping, so they
+    // must not outlive the file.
+    struct block_file {
+        static const uint32 main_net = 0xd9b4bef9;
+
+        explicit block_file(string& path, uint32 magic = main_net);
+
+        block_file(const block_file&) = delete;
+        block_file& operator=(const block_file&) = delete;
+
+        bool valid() const {
+            return Data != nullptr;
+        }
+
+        N blocks() const {
+            return Blocks.size();
+        }
+
+        // the serialized block.
+        slice<byte> serialized(N) const;
+
+        view::block block(N b) const {
+            return view::block{serialized(b)};
+        }
+
+    private:
+        boost::iostreams::mapped_file_source File;
+        byte* Data;
+        N Size;
+
+        struct record {
+            N Offset;
+            N Size;
+        };
+
+        std::vector<record> Blocks;
+    };
+
+}
+
+#endif
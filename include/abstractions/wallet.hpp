@@ -6,6 +6,9 @@
 
 #include <abstractions/pattern.hpp>
 #include <abstractions/abstractions.hpp>
+#include <abstractions/utxo.hpp>
+#include <abstractions/select.hpp>
+#include <abstractions/timechain/cached/transaction.hpp>
 
 namespace abstractions {
     
@@ -26,23 +29,49 @@ namespace abstractions {
         using spendable = data::map::entry<tag, debit<out, point>>;
         using recognizable = pattern::abstract::recognizable<key, script, tag, tx>&;
         
-        satoshi Balance;
+        // a transaction that remembers its id between 
+        // update and confirm. 
+        using cached = timechain::transaction::cached<tx, std::decay_t<decltype(std::declval<const tx&>().id())>>;
         
         list<recognizable> Recognize;
         
         list<key> Keys;
             
-        list<debit<out, point>> Entries;
+        // unspent outputs by outpoint and by tag. Copies are 
+        // cheap and are not changed by changes to the original, 
+        // so a copy is a snapshot of the funds. 
+        utxo<point, out, tag> Entries;
             
         map<tag, key> Tags; 
         
         funds import(key);
         
         // Look for any inputs that redeem outputs in our funds
-        // and any outputs that we can add to our funds. 
-        funds update(tx t);
+        // and any outputs that we can add to our funds. New 
+        // outputs are unconfirmed. 
+        funds& update(const cached& t);
         
-        funds(list<recognizable> r) : Balance{empty}, Recognize{r} {}
+        // mark the outputs of a transaction as confirmed. 
+        funds& confirm(const cached& t);
+        
+        // balances are kept up to date by update and confirm. 
+        satoshi balance() const {
+            return Entries.value();
+        }
+        
+        satoshi balance(const tag& t) const {
+            return Entries.value(t);
+        }
+        
+        satoshi confirmed() const {
+            return Entries.confirmed();
+        }
+        
+        satoshi unconfirmed() const {
+            return Entries.unconfirmed();
+        }
+        
+        funds(list<recognizable> r) : Recognize{r}, Keys{}, Entries{}, Tags{} {}
             
     };
         
@@ -86,7 +115,9 @@ namespace abstractions {
             spent(tx t, wallet w) : Transaction{t}, Remainder{w} {}
         };
         
-        spent spend(list<data::map::entry<tag, satoshi>> to, satoshi fee) const;
+        // inputs are chosen to pay for the outputs and for the fee 
+        // that the options give for the size of the transaction. 
+        spent spend(list<data::map::entry<tag, satoshi>> to, const select::options& = select::standard) const;
             
         wallet(funds f, list<payable> pay, index change, 
             list<key> source) : Funds{f}, Pay{pay}, Change{change}, Source{source} {}
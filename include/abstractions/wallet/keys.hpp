@@ -5,6 +5,7 @@
 #define ABSTRACTIONS_WALLET_KEYS
 
 #include <abstractions/crypto/secp256k1.hpp>
+#include <abstractions/crypto/batch.hpp>
 #include <abstractions/crypto/hash/sha256.hpp>
 #include <abstractions/crypto/hash/ripemd160.hpp>
 #include "tag.hpp"
@@ -55,6 +56,9 @@ namespace abstractions {
         
         constexpr data::math::module<pubkey, secret> is_module{};
         constexpr data::crypto::signature_scheme<secret, pubkey, const sha256::digest, signature> is_signature_scheme{};
+        
+        // verify many signatures at once. 
+        using batch = crypto::batch<pubkey, sha256::digest, signature>;
     
         namespace wif {
             // 52 characters base58, starts with a 'K' or 'L'
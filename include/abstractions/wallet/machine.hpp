@@ -11,6 +11,14 @@ namespace abstractions {
     namespace bitcoin {
         
         using machine = sv::machine;
+        
+        using native_machine = sv::native_machine;
+        
+        // verify every input of a transaction in parallel. 
+        inline bool verify(const transaction& t, const std::vector<output>& spent, N threads = 0, 
+            uint32 flags = abstractions::script::interpreter::verify_default) {
+            return sv::verify(t, spent, threads, flags);
+        }
 
     }
 
@@ -0,0 +1,79 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_WALLET_SIGHASH
+#define ABSTRACTIONS_WALLET_SIGHASH
+
+#include <abstractions/abstractions.hpp>
+#include <abstractions/crypto/hash/sha256.hpp>
+
+namespace abstractions {
+    
+    namespace bitcoin {
+        
+        namespace sighash {
+            
+            enum directive : uint32 {
+                all = 1, 
+                none = 2, 
+                single = 3, 
+                fork_id = 0x40, 
+                anyone_can_pay = 0x80
+            };
+            
+            // The parts of the signature hash (BIP 143 with the fork id) 
+            // which are the same for every input of a transaction. With 
+            // these, hashing for every input of a transaction is linear 
+            // in the size of the transaction rather than quadratic. 
+            struct context {
+                explicit context(bytes& transaction);
+                context() : context{std::vector<byte>{}} {}
+                
+                bool valid() const {
+                    return Valid;
+                }
+                
+                N inputs() const {
+                    return Inputs.size();
+                }
+                
+                bytes& transaction() const {
+                    return Transaction;
+                }
+                
+                // the hash that is signed in the given input. The script code 
+                // and amount are those of the output that the input spends. 
+                sha256::digest hash(N input, bytes& script_code, satoshi amount, uint32 d = all | fork_id) const;
+                
+            private:
+                std::vector<byte> Transaction;
+                bool Valid;
+                
+                sha256::digest HashPrevouts;
+                sha256::digest HashSequence;
+                sha256::digest HashOutputs;
+                
+                // position of the outpoint and sequence of each input. 
+                struct input {
+                    N Outpoint;
+                    N Sequence;
+                };
+                
+                // position and size of each output. 
+                struct output {
+                    N Offset;
+                    N Size;
+                };
+                
+                std::vector<input> Inputs;
+                std::vector<output> Outputs;
+                N Locktime;
+            };
+            
+        }
+        
+    }
+    
+}
+
+#endif
@@ -9,12 +9,14 @@
 
 namespace abstractions::bitcoin {
 
+    // inputs are signed with a context which holds the parts 
+    // of the signature hash that every input shares. 
     using redeemer = abstractions::pattern::abstract::redeemer<const secret&, const script,
-        const abstractions::transaction<input, output>&>&;
+        const sighash::context&>&;
     using pattern = abstractions::pattern::abstract::pattern<const secret&, const script,
-        const abstractions::transaction<input, output>&>&;
+        const sighash::context&>&;
     
-    using vertex = vertex<const secret&, const script, txid>;
+    using vertex = vertex<const secret&, const script, txid, sighash::context>;
     using spendable = vertex::spendable;
     
 }
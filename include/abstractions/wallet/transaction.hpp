@@ -9,6 +9,9 @@
 #include "output.hpp"
 #include "txid.hpp"
 #include "keys.hpp"
+#include "sighash.hpp"
+#include <abstractions/serialize.hpp>
+#include <abstractions/timechain/cached/transaction.hpp>
 
 namespace abstractions {
     
@@ -40,8 +43,10 @@ namespace abstractions {
                 representation(list<input> i, list<output> o, op_return d) :
                     parent::representation{i, o}, OpReturn{d} {}
             
+                // hash the serialization without building a transaction. 
                 txid id() const {
-                    return transaction{*this}.id();
+                    parent::representation r = deconvert();
+                    return hash512(r.valid() ? serialize::write(r) : std::vector<byte>{});
                 }
                 
                 bool valid() const {
@@ -66,7 +71,7 @@ namespace abstractions {
                     return *this;
                 }
             public:
-                representation(transaction t) : parent::representation{t}, OpReturn{get_op_return_data()} {};
+                representation(transaction t) : parent::representation{t.read()}, OpReturn{get_op_return_data()} {};
             };
             
             transaction& operator=(transaction);
@@ -90,7 +95,21 @@ namespace abstractions {
             
         };
     
-        signature sign(output, transaction, N, secret);
+        // a transaction that hashes itself only once. 
+        using cached_transaction = timechain::transaction::cached<transaction, txid>;
+        
+        // serialize a transaction and hash it right away, while 
+        // its bytes are still in the cache. 
+        inline cached_transaction write(const transaction::representation& r) {
+            transaction t{r};
+            txid id = t.id();
+            return cached_transaction{t, id};
+        }
+        
+        // sign an input with a context made from the transaction 
+        // that the input belongs to. The signature ends with the 
+        // sighash type, as it is pushed in a script. 
+        signature sign(output, const sighash::context&, N, secret, uint32 d = sighash::all | sighash::fork_id);
         
     }
 
@@ -0,0 +1,191 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef ABSTRACTIONS_WORK_JOBS
+#define ABSTRACTIONS_WORK_JOBS
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <abstractions/work/work.hpp>
+
+namespace abstractions::work {
+    
+    // A position in the search for a solution to an order. 
+    // Every nonce below Cursor has already been tried. 
+    struct checkpoint {
+        order Order;
+        uint64 Cursor;
+        
+        static const N size = 80;
+        
+        // 32 bytes reference, 36 bytes message, 
+        // 4 bytes target, 8 bytes cursor. 
+        bytes write() const;
+        static checkpoint read(bytes&);
+        
+        checkpoint(order o, uint64 c) : Order{o}, Cursor{c} {}
+        checkpoint() : Order{}, Cursor{0} {}
+    };
+    
+    // A pool of threads which works on many orders at once. Easier 
+    // targets are scheduled first. Jobs are mined in slices, and the 
+    // threads searching a slice check every few thousand nonces 
+    // whether the job has been paused, cancelled or has expired. 
+    // What is left of an interrupted slice is searched later. A 
+    // checkpoint can be taken of any job at any time so that it can
+    // be resumed later without repeating work already done. 
+    class jobs {
+    public:
+        using id = uint64;
+        using clock = std::chrono::steady_clock;
+        
+        enum status : byte {
+            unknown, 
+            pending, 
+            paused, 
+            solved, 
+            cancelled, 
+            expired, 
+            exhausted, 
+            invalid
+        };
+        
+        // number of nonces a thread takes from a job at once. 
+        static const uint64 default_slice_size = uint64(1) << 22;
+        
+        // if threads is zero, one thread per core is used. 
+        explicit jobs(N threads, uint64 slice_size = default_slice_size);
+        jobs() : jobs{0} {}
+        
+        // stops all threads. Unfinished jobs can be 
+        // saved with checkpoints() beforehand. 
+        ~jobs();
+        
+        jobs(const jobs&) = delete;
+        jobs& operator=(const jobs&) = delete;
+        
+        id submit(order o) {
+            return resume(checkpoint{o, 0});
+        }
+        
+        id submit(order o, clock::duration timeout) {
+            return resume(checkpoint{o, 0}, timeout);
+        }
+        
+        id resume(checkpoint);
+        id resume(checkpoint, clock::duration timeout);
+        
+        void pause(id);
+        void unpause(id);
+        void cancel(id);
+        
+        // stop keeping track of a job, cancelling it if it is not 
+        // finished. Jobs are kept until they are forgotten, so that 
+        // their state and solution can be read. 
+        void forget(id);
+        
+        status state(id) const;
+        
+        // the solution to a job, or an empty candidate if it is not solved. 
+        candidate solution(id) const;
+        
+        // block until the job is finished. 
+        status wait(id);
+        
+        // the current position of a job. 
+        checkpoint save(id) const;
+        
+        // checkpoints for every job that is pending or paused. 
+        std::vector<checkpoint> checkpoints() const;
+        
+    private:
+        struct job {
+            id Id;
+            order Order;
+            
+            // easier targets have larger magnitudes. 
+            uint64 Magnitude;
+            
+            // the first nonce that has not been given to a thread. 
+            uint64 Next;
+            
+            // beginnings of slices that are being searched. 
+            std::set<uint64> Slices;
+            
+            // what was left of slices that were interrupted. 
+            std::set<std::pair<uint64, uint64>> Unfinished;
+            
+            clock::time_point Deadline;
+            status Status;
+            candidate Solution;
+            
+            // tells the threads searching this job to give up. 
+            std::atomic<bool> Stop;
+            
+            // erase the job once no thread is searching it. 
+            bool Forgotten;
+            
+            job(id i, checkpoint c, clock::time_point d) : 
+                Id{i}, Order{c.Order}, Magnitude{c.Order.Target.magnitude()}, 
+                Next{c.Cursor}, Slices{}, Unfinished{}, Deadline{d}, 
+                Status{c.Order.valid() ? pending : invalid}, Solution{}, Stop{false}, Forgotten{false} {}
+            
+            // the key of the job in the queue. 
+            std::pair<uint64, id> priority() const {
+                return {Magnitude, Id};
+            }
+            
+            // every nonce below the cursor has been tried. 
+            uint64 cursor() const;
+            
+            // whether there are nonces left to give to a thread. 
+            bool left() const;
+            
+            // the status, counting a deadline that has passed 
+            // even if no thread has noticed yet. 
+            status state(clock::time_point now) const;
+        };
+        
+        // easiest target first and then the first to be submitted. 
+        struct easier {
+            bool operator()(const std::pair<uint64, id>& a, const std::pair<uint64, id>& b) const {
+                return a.first != b.first ? a.first > b.first : a.second < b.second;
+            }
+        };
+        
+        mutable std::mutex Mutex;
+        std::condition_variable Work;
+        std::condition_variable Finished;
+        std::map<id, job> Jobs;
+        
+        // pending jobs with nonces left to hand out. 
+        std::set<std::pair<uint64, id>, easier> Queue;
+        
+        // pending and paused jobs which can expire, soonest first. 
+        std::set<std::pair<clock::time_point, id>> Deadlines;
+        
+        uint64 SliceSize;
+        id Counter;
+        bool Stopping;
+        std::vector<std::thread> Threads;
+        
+        id add(checkpoint, clock::time_point);
+        
+        // a job that has not been forgotten. 
+        job* find(id);
+        const job* find(id) const;
+        
+        void schedule(job&);
+        job* next(std::unique_lock<std::mutex>&);
+        void finish(job&, status);
+        void run();
+    };
+    
+}
+
+#endif
@@ -4,6 +4,8 @@
 #ifndef ABSTRACTIONS_WORK_WORK
 #define ABSTRACTIONS_WORK_WORK
 
+#include <atomic>
+
 #include <abstractions/abstractions.hpp>
 #include <abstractions/crypto/hash/sha256.hpp>
 #include <abstractions/wallet/keys.hpp>
@@ -53,23 +55,80 @@ namespace abstractions::work {
             return expand();
         }
         
+        // A number which is ordered the same way as the expanded 
+        // target, so that targets can be compared without expanding 
+        // them. The value is shifted up until its first byte is 
+        // not zero so that every target has only one form. Invalid 
+        // targets are less than every valid target. 
+        uint64 magnitude() const {
+            // the exponent of an invalid target could wrap below. 
+            if (!valid()) return 0;
+            byte e = exponent();
+            uint24 v = value();
+            while (v <= 0xffff) {
+                v <<= 8;
+                e--;
+            }
+            return (uint64(e) << 24) + v;
+        }
+        
         bool operator<(target t) const {
-            return expand() < t.expand();
+            return magnitude() < t.magnitude();
         } 
         
         bool operator<=(target t) const {
-            return expand() <= t.expand();
+            return magnitude() <= t.magnitude();
         } 
         
         bool operator>(target t) const {
-            return expand() > t.expand();
+            return magnitude() > t.magnitude();
         } 
         
         bool operator>=(target t) const {
-            return expand() >= t.expand();
+            return magnitude() >= t.magnitude();
         } 
     };
     
+    // A target expanded once and stored in a form 
+    // that digests can be compared against quickly. 
+    struct threshold {
+        // the expanded target, most significant word first. 
+        std::array<uint64, 4> Words;
+        
+        // the number of most significant bytes of the expanded target that are zero. 
+        byte Zeros;
+        
+        // whether the least significant byte of a digest comes first. 
+        bool Little;
+        
+        // an invalid target is satisfied by nothing. 
+        explicit threshold(target);
+        
+        // whether d is less than the target. 
+        bool below(const sha256::digest& d) const {
+            const std::array<byte, 32>& b = static_cast<const std::array<byte, 32>&>(d);
+            
+            // most digests are rejected by their most significant byte. 
+            if (Zeros > 0 && b[Little ? 31 : 0] != 0) return false;
+            
+            for (int i = 0; i < 4; i++) {
+                uint64 w = word(b, i);
+                if (w != Words[i]) return w < Words[i];
+            }
+            
+            return false;
+        }
+        
+    private:
+        // the i'th most significant word of a digest. 
+        uint64 word(const std::array<byte, 32>& b, int i) const {
+            uint64 w = 0;
+            if (Little) for (int j = 31 - 8 * i; j > 23 - 8 * i; j--) w = (w << 8) + b[j];
+            else for (int j = 8 * i; j < 8 * i + 8; j++) w = (w << 8) + b[j];
+            return w;
+        }
+    };
+    
     const target easy{32, 0x00ffffff}; 
     const target hard{3, 0x00000001};
         
@@ -105,6 +164,11 @@ namespace abstractions::work {
             return uint640::words_type::make(*this)[19];
         }
         
+        // change the nonce without touching the rest of the candidate. 
+        void nonce(uint32 n) {
+            uint640::words_type::make(*this)[19] = n;
+        }
+        
         bool valid() const {
             return order().valid();
         };
@@ -112,9 +176,27 @@ namespace abstractions::work {
         candidate(uint32 version, struct order o, uint32 nonce);
         candidate() : uint640{} {}
         
-        bool satisfied() const {
-            return sha256::hash<80>(*this) < target().expand();
+        // the threshold is made from the target once 
+        // and reused for every candidate of an order. 
+        bool satisfied(const threshold& t) const {
+            return t.below(sha256::hash<80>(*this));
         }
+        
+        // The first 64 bytes of a candidate do not depend on the nonce, 
+        // so they can be compressed once and reused for every nonce. 
+        sha256::midstate prefix() const {
+            return sha256::prefix<80>(*this);
+        }
+        
+        bool satisfied(const sha256::midstate& m, const threshold& t) const {
+            return t.below(sha256::hash<80>(m, *this));
+        }
+        
+        // try count consecutive nonces beginning with this candidate's
+        // nonce, hashing as many at once as the cpu allows. Returns the 
+        // position of the first nonce that satisfies the target, or 
+        // count if there is none. 
+        N satisfied(const sha256::midstate& m, const threshold& t, N count) const;
     };
     
     inline message bitcoin_header(const sha256::digest& d, uint32 timestamp) {
@@ -131,7 +213,40 @@ namespace abstractions::work {
         return m;
     };
     
-    candidate work(order);
+    // result of a nonce search, with enough information 
+    // to compute the hash rate that was achieved. 
+    struct report {
+        candidate Candidate;
+        uint64 Hashes;
+        double Seconds;
+        
+        double hashes_per_second() const {
+            return Seconds > 0 ? Hashes / Seconds : 0;
+        }
+        
+        report() : Candidate{}, Hashes{0}, Seconds{0} {}
+        report(candidate c, uint64 h, double s) : Candidate{c}, Hashes{h}, Seconds{s} {}
+    };
+    
+    // search the nonces from cursor up to end in order until one 
+    // satisfies the order or stop is set. The cursor is left at the
+    // first nonce that has not been tried. If a solution is found, 
+    // it is written to solution and true is returned. 
+    bool search(order, uint64& cursor, uint64 end, const std::atomic<bool>& stop, candidate& solution);
+    
+    // search for a solution to the given order by dividing 
+    // the nonce space into as many ranges as there are threads. 
+    // All threads stop as soon as any of them finds a solution. 
+    // If threads is zero, one thread per core is used. 
+    report search(order, N threads);
+    
+    inline candidate work(order o, N threads) {
+        return search(o, threads).Candidate;
+    }
+    
+    inline candidate work(order o) {
+        return work(o, 0);
+    }
     
 }
 
@@ -5,6 +5,10 @@
 #define SATOSHI_SV_MACHINE
 
 #include <abstractions/script/machine.hpp>
+#include <abstractions/script/interpreter.hpp>
+
+#include <atomic>
+#include <thread>
 
 #include <satoshi_sv/src/script/bitcoinconsensus.h>
 #include <satoshi_sv/src/script/script.h>
@@ -27,22 +31,47 @@ namespace abstractions::sv {
         // Run the machine with checking signatures. 
         sv_machine(const CTransaction& tx, index i, satoshi amount) : Checker{&tx, i, sv::Amount{amount}}, Flags{verify_all} {}
         
+        // Run the machine with the parts of the signature hash which are 
+        // shared by every input of the transaction already computed. 
+        sv_machine(const CTransaction& tx, const PrecomputedTransactionData& d, index i, satoshi amount) : 
+            Checker{&tx, i, sv::Amount{amount}, d}, Flags{verify_all} {}
+        
         bool run(const CScript& output, const CScript& input) const {
-            sv::VerifyScript(input, output, Flags, Checker);
+            return sv::VerifyScript(input, output, Flags, Checker);
         }
         
     };
     
     constexpr static abstractions::script::machine::interface<sv_machine, CScript&, const CTransaction&> sv_machine_is_machine{};
     
+    // A transaction converted once, with the hashes of its prevouts, 
+    // sequences and outputs, which every input's sighash needs. 
+    struct prepared : public script::interpreter::transaction {
+        CTransaction Transaction;
+        PrecomputedTransactionData Data;
+        
+        prepared(const bitcoin::transaction& tx) : Transaction{convert(tx)}, Data{Transaction} {}
+        prepared(const prepared&) = delete;
+        
+        pointer<script::interpreter::checker> input(index i, satoshi amount, uint32 flags) const final override;
+    };
+    
     struct machine {
     private:
+        pointer<prepared> Prepared;
         sv_machine Machine;
     public:
-        machine() : Machine{} {}
+        machine() : Prepared{}, Machine{} {}
         
         // Run the machine with checking signatures. 
-        machine(const bitcoin::transaction& tx, index i, satoshi amount) : Machine{convert(tx), i, amount} {}
+        machine(const bitcoin::transaction& tx, index i, satoshi amount) : 
+            Prepared{std::make_shared<prepared>(tx)}, 
+            Machine{Prepared->Transaction, Prepared->Data, i, amount} {}
+        
+        // check an input of a transaction which has already been 
+        // prepared, so that many inputs can share the same one. 
+        machine(const pointer<prepared>& p, index i, satoshi amount) : 
+            Prepared{p}, Machine{Prepared->Transaction, Prepared->Data, i, amount} {}
         
         bool run(const bitcoin::script& output, const bitcoin::script& input) const {
             return Machine.run(convert(output), convert(input));
@@ -52,6 +81,88 @@ namespace abstractions::sv {
     
     constexpr static abstractions::script::machine::interface<machine, const bitcoin::script&, const bitcoin::transaction&> machine_is_machine{};
     
+    // Satoshi's signature checker for the native interpreter. 
+    struct checker : public script::interpreter::checker {
+    private:
+        TransactionSignatureChecker Checker;
+        uint32_t Flags;
+    public:
+        checker(const prepared& p, index i, satoshi amount, uint32_t flags) : 
+            Checker{&p.Transaction, i, sv::Amount{amount}, p.Data}, Flags{flags} {}
+        
+        bool check_signature(bytes& signature, bytes& pubkey, bytes& script_code) const final override {
+            return Checker.CheckSig(signature, pubkey, CScript(script_code.data(), script_code.data() + script_code.size()), Flags);
+        }
+        
+        bool check_locktime(int64_t n) const final override {
+            return Checker.CheckLockTime(CScriptNum{n});
+        }
+        
+        bool check_sequence(int64_t n) const final override {
+            return Checker.CheckSequence(CScriptNum{n});
+        }
+    };
+    
+    inline pointer<script::interpreter::checker> prepared::input(index i, satoshi amount, uint32 flags) const {
+        return std::make_shared<checker>(*this, i, amount, flags);
+    }
+    
+    // Runs scripts with the native interpreter, so that nothing is 
+    // converted when a script is run. 
+    struct native_machine {
+    private:
+        pointer<prepared> Prepared;
+        script::interpreter Interpreter;
+    public:
+        native_machine() : Prepared{}, Interpreter{} {}
+        
+        native_machine(const bitcoin::transaction& tx, index i, satoshi amount, uint32 flags = script::interpreter::verify_default) : 
+            Prepared{std::make_shared<prepared>(tx)}, 
+            Interpreter{*Prepared, i, amount, flags} {}
+        
+        bool run(const bitcoin::script& output, const bitcoin::script& input) const {
+            return Interpreter.run(output, input);
+        }
+        
+    };
+    
+    constexpr static abstractions::script::machine::interface<native_machine, const bitcoin::script&, const bitcoin::transaction&> native_machine_is_machine{};
+    
+    // Verify every input of a transaction, given the outputs that it spends 
+    // in the same order. The transaction is prepared once and shared by 
+    // all the inputs, which are divided among the given number of threads 
+    // (0 for one per core). 
+    inline bool verify(const bitcoin::transaction& tx, const std::vector<bitcoin::output>& spent, N threads = 0, 
+        uint32 flags = script::interpreter::verify_default) {
+        const prepared p{tx};
+        const N inputs = p.Transaction.vin.size();
+        if (inputs != spent.size()) return false;
+        
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        if (threads > inputs) threads = inputs;
+        
+        std::atomic<N> next{0};
+        std::atomic<bool> failed{false};
+        
+        auto worker = [&p, &spent, &next, &failed, inputs, flags]() {
+            for (N i = next++; i < inputs && !failed; i = next++) {
+                const CScript& s = p.Transaction.vin[i].scriptSig;
+                const checker c{p, index(i), spent[i].Value, flags};
+                if (!script::interpreter{c, flags}.run(spent[i].ScriptPubKey, std::vector<byte>(s.begin(), s.end()))) failed = true;
+            }
+        };
+        
+        // the calling thread is one of the workers. 
+        std::vector<std::thread> workers{};
+        workers.reserve(threads);
+        for (N i = 1; i < threads; i++) workers.emplace_back(worker);
+        worker();
+        for (std::thread& t : workers) t.join();
+        
+        return !failed;
+    }
+    
 } 
 
 #endif
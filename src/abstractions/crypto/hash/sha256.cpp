@@ -0,0 +1,333 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/crypto/hash/sha256.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ABSTRACTIONS_SHA256_X86
+#include <immintrin.h>
+#endif
+
+namespace abstractions::sha256 {
+    
+    namespace {
+        
+        const uint32 K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+        
+        inline uint32 rotate(uint32 x, int n) {
+            return (x >> n) | (x << (32 - n));
+        }
+        
+        inline uint32 read_big(const byte* b) {
+            return (uint32(b[0]) << 24) | (uint32(b[1]) << 16) | (uint32(b[2]) << 8) | uint32(b[3]);
+        }
+        
+        inline void write_big(byte* b, uint32 x) {
+            b[0] = byte(x >> 24);
+            b[1] = byte(x >> 16);
+            b[2] = byte(x >> 8);
+            b[3] = byte(x);
+        }
+        
+        void compress_generic(uint32* state, const byte* block) {
+            uint32 w[64];
+            for (int i = 0; i < 16; i++) w[i] = read_big(block + 4 * i);
+            for (int i = 16; i < 64; i++) {
+                uint32 s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32 s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            
+            uint32 a = state[0], b = state[1], c = state[2], d = state[3], 
+                e = state[4], f = state[5], g = state[6], h = state[7];
+            
+            for (int i = 0; i < 64; i++) {
+                uint32 t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                uint32 t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+        
+#ifdef ABSTRACTIONS_SHA256_X86
+        // uses the sha extensions if the cpu has them. 
+        __attribute__((target("sha,sse4.1"))) void compress_sha(uint32* state, const byte* block) {
+            const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+            
+            __m128i t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0xb1);
+            __m128i s1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(state + 4)), 0x1b);
+            __m128i s0 = _mm_alignr_epi8(t, s1, 8);
+            s1 = _mm_blend_epi16(s1, t, 0xf0);
+            
+            const __m128i abef = s0;
+            const __m128i cdgh = s1;
+            
+            __m128i w[4];
+            for (int i = 0; i < 4; i++) w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(block + 16 * i)), mask);
+            
+            for (int i = 0; i < 16; i++) {
+                __m128i m = _mm_add_epi32(w[i % 4], _mm_loadu_si128((const __m128i*)(K + 4 * i)));
+                s1 = _mm_sha256rnds2_epu32(s1, s0, m);
+                s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(m, 0x0e));
+                if (i < 12) w[i % 4] = _mm_sha256msg2_epu32(
+                    _mm_add_epi32(_mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]), _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4)), 
+                    w[(i + 3) % 4]);
+            }
+            
+            s0 = _mm_add_epi32(s0, abef);
+            s1 = _mm_add_epi32(s1, cdgh);
+            
+            t = _mm_shuffle_epi32(s0, 0x1b);
+            s1 = _mm_shuffle_epi32(s1, 0xb1);
+            _mm_storeu_si128((__m128i*)state, _mm_blend_epi16(t, s1, 0xf0));
+            _mm_storeu_si128((__m128i*)(state + 4), _mm_alignr_epi8(s1, t, 8));
+        }
+#endif
+        
+        using compressor = void (*)(uint32*, const byte*);
+        
+        compressor select_compressor() {
+#ifdef ABSTRACTIONS_SHA256_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1")) return compress_sha;
+#endif
+            return compress_generic;
+        }
+        
+        const compressor& best_compressor() {
+            static const compressor c = select_compressor();
+            return c;
+        }
+        
+        inline void compress(std::array<uint32, 8>& state, const byte* block) {
+            best_compressor()(state.data(), block);
+        }
+        
+        digest finish_with(compressor c, const midstate& m, const byte* b, N size) {
+            std::array<uint32, 8> state = m.State;
+            uint64 bits = (m.Length + size) * 8;
+            
+            for (; size >= 64; size -= 64, b += 64) c(state.data(), b);
+            
+            // padding takes one block if there is room for 
+            // the 0x80 byte and the length, and two otherwise.
+            byte last[128]{};
+            std::copy(b, b + size, last);
+            last[size] = 0x80;
+            N blocks = size < 56 ? 1 : 2;
+            write_big(last + 64 * blocks - 8, uint32(bits >> 32));
+            write_big(last + 64 * blocks - 4, uint32(bits));
+            for (N i = 0; i < blocks; i++) c(state.data(), last + 64 * i);
+            
+            std::array<byte, 32> out;
+            for (int i = 0; i < 8; i++) write_big(out.data() + 4 * i, state[i]);
+            digest d{};
+            std::copy(out.begin(), out.end(), d.begin());
+            return d;
+        }
+        
+        // Many messages are hashed at once by putting one word
+        // of each in each lane of a vector. The same code is 
+        // compiled for several instruction sets below. 
+        template <N L> struct lanes_of {
+            typedef uint32 type __attribute__((vector_size(4 * L)));
+        };
+        
+        // a macro rather than a function so that no vector is 
+        // ever passed by value outside of the target functions. 
+#define rotate_lanes(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+        
+        template <N L>
+        inline __attribute__((always_inline)) void compress_lanes(typename lanes_of<L>::type* state, const byte* const* blocks) {
+            using V = typename lanes_of<L>::type;
+            V w[64];
+            for (int i = 0; i < 16; i++) for (N j = 0; j < L; j++) w[i][j] = read_big(blocks[j] + 4 * i);
+            for (int i = 16; i < 64; i++) {
+                V s0 = rotate_lanes(w[i - 15], 7) ^ rotate_lanes(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                V s1 = rotate_lanes(w[i - 2], 17) ^ rotate_lanes(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            
+            V a = state[0], b = state[1], c = state[2], d = state[3], 
+                e = state[4], f = state[5], g = state[6], h = state[7];
+            
+            for (int i = 0; i < 64; i++) {
+                V t1 = h + (rotate_lanes(e, 6) ^ rotate_lanes(e, 11) ^ rotate_lanes(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                V t2 = (rotate_lanes(a, 2) ^ rotate_lanes(a, 13) ^ rotate_lanes(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+        
+        // finish exactly L messages. 
+        template <N L>
+        inline __attribute__((always_inline)) void finish_lanes(const midstate& m, const byte* tails, N size, digest* out) {
+            using V = typename lanes_of<L>::type;
+            V state[8];
+            for (int i = 0; i < 8; i++) state[i] = V{} + m.State[i];
+            uint64 bits = (m.Length + size) * 8;
+            
+            const byte* blocks[L];
+            N offset = 0;
+            for (; size - offset >= 64; offset += 64) {
+                for (N j = 0; j < L; j++) blocks[j] = tails + j * size + offset;
+                compress_lanes<L>(state, blocks);
+            }
+            
+            N rest = size - offset;
+            N count = rest < 56 ? 1 : 2;
+            byte last[L][128];
+            for (N j = 0; j < L; j++) {
+                std::fill(last[j], last[j] + 64 * count, 0);
+                std::copy(tails + j * size + offset, tails + j * size + size, last[j]);
+                last[j][rest] = 0x80;
+                write_big(last[j] + 64 * count - 8, uint32(bits >> 32));
+                write_big(last[j] + 64 * count - 4, uint32(bits));
+            }
+            
+            for (N i = 0; i < count; i++) {
+                for (N j = 0; j < L; j++) blocks[j] = last[j] + 64 * i;
+                compress_lanes<L>(state, blocks);
+            }
+            
+            for (N j = 0; j < L; j++) {
+                std::array<byte, 32> o;
+                for (int i = 0; i < 8; i++) write_big(o.data() + 4 * i, state[i][j]);
+                std::copy(o.begin(), o.end(), out[j].begin());
+            }
+        }
+        
+        using finisher = void (*)(const midstate&, const byte*, N, digest*);
+        
+#ifdef ABSTRACTIONS_SHA256_X86
+        __attribute__((target("sse4.1"))) void finish_4(const midstate& m, const byte* tails, N size, digest* out) {
+            finish_lanes<4>(m, tails, size, out);
+        }
+        
+        __attribute__((target("avx2"))) void finish_8(const midstate& m, const byte* tails, N size, digest* out) {
+            finish_lanes<8>(m, tails, size, out);
+        }
+        
+        __attribute__((target("avx512f"))) void finish_16(const midstate& m, const byte* tails, N size, digest* out) {
+            finish_lanes<16>(m, tails, size, out);
+        }
+#else
+        void finish_4(const midstate& m, const byte* tails, N size, digest* out) {
+            finish_lanes<4>(m, tails, size, out);
+        }
+#endif
+        
+        void finish_generic(const midstate& m, const byte* tails, N size, digest* out) {
+            *out = finish_with(compress_generic, m, tails, size);
+        }
+        
+#ifdef ABSTRACTIONS_SHA256_X86
+        void finish_sha(const midstate& m, const byte* tails, N size, digest* out) {
+            *out = finish_with(compress_sha, m, tails, size);
+        }
+#endif
+        
+        struct kernel {
+            N Lanes;
+            finisher Finish;
+        };
+        
+        kernel select_kernel() {
+#ifdef ABSTRACTIONS_SHA256_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return {16, finish_16};
+            if (__builtin_cpu_supports("avx2")) return {8, finish_8};
+            if (__builtin_cpu_supports("sse4.1")) return {4, finish_4};
+            return {1, nullptr};
+#else
+            return {4, finish_4};
+#endif
+        }
+        
+#undef rotate_lanes
+        
+        const kernel& best() {
+            static const kernel k = select_kernel();
+            return k;
+        }
+        
+    }
+    
+    midstate::midstate() : State{
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}, Length{0} {}
+    
+    midstate::midstate(const byte* b, N size) : midstate{} {
+        for (; size >= 64; size -= 64, b += 64, Length += 64) compress(State, b);
+    }
+    
+    digest midstate::finish(const byte* b, N size) const {
+        return finish_with(best_compressor(), *this, b, size);
+    }
+    
+    N lanes() {
+        return best().Lanes;
+    }
+    
+    void finish(const midstate& m, const byte* tails, N size, N count, digest* out) {
+        const kernel& k = best();
+        N i = 0;
+        if (k.Finish != nullptr) for (; count - i >= k.Lanes; i += k.Lanes) 
+            k.Finish(m, tails + i * size, size, out + i);
+        for (; i < count; i++) out[i] = m.finish(tails + i * size, size);
+    }
+    
+    std::vector<implementation> implementations() {
+        std::vector<implementation> x{{"generic", 1, finish_generic}};
+#ifdef ABSTRACTIONS_SHA256_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1")) x.push_back({"sha", 1, finish_sha});
+        if (__builtin_cpu_supports("sse4.1")) x.push_back({"sse4.1", 4, finish_4});
+        if (__builtin_cpu_supports("avx2")) x.push_back({"avx2", 8, finish_8});
+        if (__builtin_cpu_supports("avx512f")) x.push_back({"avx512f", 16, finish_16});
+#else
+        x.push_back({"vector", 4, finish_4});
+#endif
+        return x;
+    }
+    
+}
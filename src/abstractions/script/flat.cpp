@@ -0,0 +1,101 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/script/flat.hpp>
+
+namespace abstractions::script {
+    
+    namespace {
+        
+        // number of bytes after the op code that give the size of a push. 
+        N prefix_size(program::op o) {
+            return o == program::OP_PUSHDATA1 ? 1 : o == program::OP_PUSHDATA2 ? 2 : o == program::OP_PUSHDATA4 ? 4 : 0;
+        }
+        
+    }
+    
+    byte* flat::write(byte* b) const {
+        for (const instruction& i : Instructions) {
+            *b++ = byte(i.Code);
+            if (!is_push(i.Code)) continue;
+            for (N j = 0; j < prefix_size(i.Code); j++) *b++ = byte(i.Size >> (8 * j));
+            b = std::copy(Data.data() + i.Offset, Data.data() + i.Offset + i.Size, b);
+        }
+        return b;
+    }
+    
+    flat& flat::emit(op o) {
+        return add(o, 0, 0);
+    }
+    
+    // pushes of small numbers become op codes, so 
+    // that there is only one way to write every push. 
+    program::op flat::push_code(const byte* data, N size) {
+        if (size == 0) return OP_0;
+        if (size == 1 && data[0] > 0 && data[0] <= 16) return op(data[0] + 0x50);
+        if (size == 1 && data[0] == 0x81) return OP_1NEGATE;
+        return size > 0xffff ? OP_PUSHDATA4 : size > 0xff ? OP_PUSHDATA2 : size > 75 ? OP_PUSHDATA1 : op(size);
+    }
+    
+    flat& flat::pushed(N offset) {
+        N size = Data.size() - offset;
+        op code = push_code(Data.data() + offset, size);
+        if (is_push(code)) return add(code, offset, size);
+        Data.resize(offset);
+        return emit(code);
+    }
+    
+    flat& flat::add(op code, N offset, N size) {
+        Instructions.push_back(instruction{code, uint32(offset), uint32(size)});
+        Length += 1 + prefix_size(code) + size;
+        return *this;
+    }
+    
+    flat& flat::append(const flat& f) {
+        N offset = Data.size();
+        Data.insert(Data.end(), f.Data.begin(), f.Data.end());
+        Instructions.reserve(Instructions.size() + f.Instructions.size());
+        for (instruction i : f.Instructions) {
+            if (i.Size != 0) i.Offset += uint32(offset);
+            Instructions.push_back(i);
+        }
+        Length += f.Length;
+        Valid = Valid && f.Valid;
+        return *this;
+    }
+    
+    // pushes are kept exactly as they were written 
+    // even if they are not the smallest encoding. 
+    flat& flat::read(const byte* b, N size) {
+        const byte* end = b + size;
+        while (b != end) {
+            op o = op(*b++);
+            if (!is_push(o)) {
+                emit(o);
+                continue;
+            }
+            
+            N prefix = prefix_size(o);
+            if (N(end - b) < prefix) {
+                Valid = false;
+                return *this;
+            }
+            
+            N n = 0;
+            if (prefix == 0) n = o;
+            else for (N i = 0; i < prefix; i++) n += N(*b++) << (8 * i);
+            
+            if (N(end - b) < n) {
+                Valid = false;
+                return *this;
+            }
+            
+            N offset = Data.size();
+            Data.insert(Data.end(), b, b + n);
+            add(o, offset, n);
+            b += n;
+        }
+        return *this;
+    }
+    
+}
@@ -6,21 +6,47 @@
 namespace abstractions::script {
     
     pointer<program> push(bitcoin::signature& y) {
-        std::vector<byte> x{static_cast<unsigned char>(y.size())};
+        std::vector<byte> x(y.size());
         std::copy(y.begin(), y.end(), x.begin());
         return push_data(x);
     }
     
     pointer<program> push(bitcoin::pubkey& y) {
-        std::vector<byte> x{static_cast<unsigned char>(y.size())};
+        std::vector<byte> x(y.size());
+        std::copy(y.begin(), y.end(), x.begin());
+        return push_data(x);
+    }
+    
+    pointer<program> push(secp256k1::compressed_pubkey& y) {
+        std::vector<byte> x(y.size());
+        std::copy(y.begin(), y.end(), x.begin());
+        return push_data(x);
+    }
+    
+    pointer<program> push(secp256k1::uncompressed_pubkey& y) {
+        std::vector<byte> x(y.size());
         std::copy(y.begin(), y.end(), x.begin());
         return push_data(x);
     }
     
     pointer<program> push(bitcoin::address& y) {
-        std::vector<byte> x{static_cast<unsigned char>(y.size())};
+        std::vector<byte> x(y.size());
         std::copy(y.begin(), y.end(), x.begin());
         return push_data(x);
     }
+    
+    pointer<program> push(sha256::digest& y) {
+        std::vector<byte> x(y.size());
+        std::copy(y.begin(), y.end(), x.begin());
+        return push_data(x);
+    }
+    
+    pointer<program> push(N n) {
+        byte b[9];
+        return push_data(std::vector<byte>(b, b + program::push::number(n, b)));
+    }
+    
+    pointer<program> push(uint64 n) {
+        return push(N(n));
+    }
 }
-
@@ -0,0 +1,950 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/script/interpreter.hpp>
+#include <abstractions/script/script.hpp>
+#include <abstractions/crypto/hash/sha256.hpp>
+#include <abstractions/crypto/hash/ripemd160.hpp>
+
+#if defined(__GNUC__)
+#define ABSTRACTIONS_COMPUTED_GOTO
+#endif
+
+#ifdef ABSTRACTIONS_COMPUTED_GOTO
+#define dispatch(h) goto *labels[h];
+#define handle(h) label_##h
+#else
+#define dispatch(h) switch (h)
+#define handle(h) case h
+#endif
+
+namespace abstractions::script {
+
+    const interpreter::checker interpreter::none{};
+
+    namespace {
+
+        using op = program::op;
+
+        const N max_script_size = 10000;
+        const N max_element_size = 520;
+        const N max_ops = 500;
+        const N max_stack_size = 1000;
+        const int64_t max_pubkeys = 20;
+        const N max_number_size = 4;
+
+        using element = std::vector<byte>;
+
+        // A stack that keeps the space of elements that have been
+        // popped so that later pushes can use it again.
+        struct stack {
+            std::vector<element> Elements;
+            N Size;
+
+            stack() : Elements{}, Size{0} {
+                Elements.reserve(64);
+            }
+
+            N size() const {
+                return Size;
+            }
+
+            element& push() {
+                if (Size == Elements.size()) Elements.emplace_back();
+                element& e = Elements[Size++];
+                e.clear();
+                return e;
+            }
+
+            void push(const byte* b, N n) {
+                push().assign(b, b + n);
+            }
+
+            void pop(N n = 1) {
+                Size -= n;
+            }
+
+            void clear() {
+                Size = 0;
+            }
+
+            // depth 0 is the top of the stack.
+            element& top(N depth = 0) {
+                return Elements[Size - 1 - depth];
+            }
+
+            // push a copy of the element at the given depth.
+            void copy(N depth) {
+                N i = Size - 1 - depth;
+                push();
+                Elements[Size - 1] = Elements[i];
+            }
+
+            // move the element at the given depth to the top.
+            void roll(N depth) {
+                std::rotate(Elements.begin() + (Size - 1 - depth), Elements.begin() + (Size - depth), Elements.begin() + Size);
+            }
+
+            void swap(N a, N b) {
+                std::swap(top(a), top(b));
+            }
+
+            // split the top element into two with the first n bytes underneath.
+            void split(N n) {
+                N i = Size - 1;
+                push();
+                Elements[Size - 1].assign(Elements[i].begin() + n, Elements[i].end());
+                Elements[i].resize(n);
+            }
+
+            // move the top of this stack to the top of another.
+            void move(stack& to) {
+                std::swap(to.push(), top());
+                pop();
+            }
+        };
+
+        struct arena {
+            stack Main;
+            stack Alt;
+            stack Saved;
+            std::vector<bool> Conditions;
+            element Code;
+            element Redeem;
+
+            arena() : Main{}, Alt{}, Saved{}, Conditions{}, Code{}, Redeem{} {
+                Conditions.reserve(16);
+                Code.reserve(max_script_size);
+            }
+        };
+
+        thread_local arena Arena{};
+
+        bool to_bool(const element& e) {
+            for (N i = 0; i < e.size(); i++) if (e[i] != 0) return !(i == e.size() - 1 && e[i] == 0x80);
+            return false;
+        }
+
+        bool minimally_encoded(const element& e) {
+            return e.empty() || (e.back() & 0x7f) != 0 || (e.size() > 1 && (e[e.size() - 2] & 0x80));
+        }
+
+        // read a script number of at most the given size.
+        bool read_number(const element& e, int64_t& n, bool minimal, N size = max_number_size) {
+            if (e.size() > size || (minimal && !minimally_encoded(e))) return false;
+            if (e.empty()) {
+                n = 0;
+                return true;
+            }
+
+            uint64 m = 0;
+            for (N i = 0; i < e.size(); i++) m |= uint64(e[i]) << (8 * i);
+            if (e.back() & 0x80) n = -int64_t(m & ~(uint64(0x80) << (8 * (e.size() - 1))));
+            else n = int64_t(m);
+            return true;
+        }
+
+        void write_number(int64_t n, element& e) {
+            e.clear();
+            uint64 m = n < 0 ? uint64(-n) : uint64(n);
+            for (; m > 0; m >>= 8) e.push_back(byte(m));
+            if (e.empty()) return;
+            if (e.back() & 0x80) e.push_back(n < 0 ? 0x80 : 0);
+            else if (n < 0) e.back() |= 0x80;
+        }
+
+        // remove the padding from a number.
+        void minimally_encode(element& e) {
+            if (minimally_encoded(e)) return;
+            byte last = e.back();
+            for (N i = e.size() - 1; i > 0; i--) if (e[i - 1] != 0) {
+                if (e[i - 1] & 0x80) e[i++] = last;
+                else e[i - 1] |= last;
+                e.resize(i);
+                return;
+            }
+            e.clear();
+        }
+
+        void push_number(stack& s, int64_t n) {
+            write_number(n, s.push());
+        }
+
+        void push_bool(stack& s, bool b) {
+            element& e = s.push();
+            if (b) e.push_back(1);
+        }
+
+        bool disabled(op o) {
+            switch (o) {
+                case program::OP_INVERT:
+                case program::OP_2MUL:
+                case program::OP_2DIV:
+                case program::OP_MUL:
+                case program::OP_LSHIFT:
+                case program::OP_RSHIFT:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // read the size of a push and move past it.
+        bool read_push(op o, const byte*& pc, const byte* end, N& n) {
+            N prefix = o == program::OP_PUSHDATA1 ? 1 : o == program::OP_PUSHDATA2 ? 2 : o == program::OP_PUSHDATA4 ? 4 : 0;
+            if (N(end - pc) < prefix) return false;
+            if (prefix == 0) n = o;
+            else {
+                n = 0;
+                for (N i = 0; i < prefix; i++) n += N(*pc++) << (8 * i);
+            }
+            return N(end - pc) >= n;
+        }
+
+        bool minimal_push(op o, const byte* data, N n) {
+            if (n == 0) return o == program::OP_0;
+            if (n == 1 && ((data[0] >= 1 && data[0] <= 16) || data[0] == 0x81)) return false;
+            if (n <= 75) return o == op(n);
+            if (n <= 0xff) return o == program::OP_PUSHDATA1;
+            if (n <= 0xffff) return o == program::OP_PUSHDATA2;
+            return true;
+        }
+
+        bool push_only(bytes& script) {
+            const byte* pc = script.data();
+            const byte* end = pc + script.size();
+            while (pc < end) {
+                op o = op(*pc++);
+                if (o > program::OP_16) return false;
+                N n = 0;
+                if (o <= program::OP_PUSHDATA4) {
+                    if (!read_push(o, pc, end, n)) return false;
+                    pc += n;
+                }
+            }
+            return true;
+        }
+
+        bool pay_to_script_hash(bytes& script) {
+            return script.size() == 23 && script[0] == program::OP_HASH160 && script[1] == 20 && script[22] == program::OP_EQUAL;
+        }
+
+        // BIP 66.
+        bool valid_der(const element& sig) {
+            N size = sig.size();
+            if (size < 9 || size > 73) return false;
+            if (sig[0] != 0x30 || sig[1] != size - 3) return false;
+            N r = sig[3];
+            if (5 + r >= size) return false;
+            N s = sig[5 + r];
+            if (r + s + 7 != size) return false;
+            if (sig[2] != 0x02 || r == 0 || (sig[4] & 0x80)) return false;
+            if (r > 1 && sig[4] == 0 && !(sig[5] & 0x80)) return false;
+            if (sig[r + 4] != 0x02 || s == 0 || (sig[r + 6] & 0x80)) return false;
+            if (s > 1 && sig[r + 6] == 0 && !(sig[r + 7] & 0x80)) return false;
+            return true;
+        }
+
+        // whether s is at most half the order of the curve.
+        bool low_s(const element& sig) {
+            static const byte half_order[32] = {
+                0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                0x5d, 0x57, 0x6e, 0x73, 0x57, 0xa4, 0x50, 0x1d, 0xdf, 0xe9, 0x2f, 0x46, 0x68, 0x1b, 0x20, 0xa0};
+            N r = sig[3];
+            const byte* s = sig.data() + r + 6;
+            N n = sig[r + 5];
+            while (n > 0 && *s == 0) {
+                s++;
+                n--;
+            }
+            if (n != 32) return n < 32;
+            return !std::lexicographical_compare(half_order, half_order + 32, s, s + 32);
+        }
+
+        bool valid_signature_encoding(const element& sig, uint32 flags) {
+            if (sig.empty()) return true;
+            if ((flags & (interpreter::verify_der_signatures | interpreter::verify_low_s | interpreter::verify_strict_encoding)) && !valid_der(sig)) return false;
+            if ((flags & interpreter::verify_low_s) && !low_s(sig)) return false;
+            if (flags & interpreter::verify_strict_encoding) {
+                byte type = sig.back() & ~0xc0;
+                if (type < 1 || type > 3) return false;
+                if (bool(sig.back() & 0x40) != bool(flags & interpreter::enable_fork_id)) return false;
+            }
+            return true;
+        }
+
+        bool valid_pubkey_encoding(const element& p, uint32 flags) {
+            if (!(flags & interpreter::verify_strict_encoding)) return true;
+            if (p.size() == 33) return p[0] == 0x02 || p[0] == 0x03;
+            if (p.size() == 65) return p[0] == 0x04;
+            return false;
+        }
+
+        // whether a signature is removed from the code that it signs.
+        bool deleted(const element& sig, uint32 flags) {
+            return sig.empty() || !(sig.back() & 0x40) || !(flags & interpreter::enable_fork_id);
+        }
+
+        // Satoshi's FindAndDelete, which removes every push of
+        // the signature that begins at an op code.
+        void find_and_delete(element& code, const element& sig) {
+            // the signature pushed the way Satoshi's CScript pushes it.
+            std::vector<byte> pattern{};
+            pattern.reserve(sig.size() + 5);
+            if (sig.size() < program::OP_PUSHDATA1) pattern.push_back(byte(sig.size()));
+            else if (sig.size() <= 0xff) {
+                pattern.push_back(program::OP_PUSHDATA1);
+                pattern.push_back(byte(sig.size()));
+            } else if (sig.size() <= 0xffff) {
+                pattern.push_back(program::OP_PUSHDATA2);
+                pattern.push_back(byte(sig.size()));
+                pattern.push_back(byte(sig.size() >> 8));
+            } else {
+                pattern.push_back(program::OP_PUSHDATA4);
+                for (int i = 0; i < 4; i++) pattern.push_back(byte(sig.size() >> (8 * i)));
+            }
+            pattern.insert(pattern.end(), sig.begin(), sig.end());
+            const N size = pattern.size();
+
+            N read = 0;
+            N written = 0;
+            while (read < code.size()) {
+                while (code.size() - read >= size && std::equal(pattern.begin(), pattern.end(), code.begin() + read)) read += size;
+                if (read >= code.size()) break;
+
+                const byte* end = code.data() + code.size();
+                const byte* pc = code.data() + read;
+                op o = op(*pc++);
+                N n = 0;
+                if (o <= program::OP_PUSHDATA4 && !read_push(o, pc, end, n)) pc = end;
+                else pc += n;
+
+                N next = pc - code.data();
+                std::copy(code.begin() + read, code.begin() + next, code.begin() + written);
+                written += next - read;
+                read = next;
+            }
+            code.resize(written);
+        }
+
+        uint32 rotate(uint32 x, int n) {
+            return (x << n) | (x >> (32 - n));
+        }
+
+        // OP_SHA1 is the only thing that uses sha1.
+        void sha1(element& e) {
+            uint32 h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+            std::vector<byte> m{e};
+            uint64 bits = uint64(e.size()) * 8;
+            m.push_back(0x80);
+            while (m.size() % 64 != 56) m.push_back(0);
+            for (int i = 7; i >= 0; i--) m.push_back(byte(bits >> (8 * i)));
+
+            for (N block = 0; block < m.size(); block += 64) {
+                uint32 w[80];
+                for (int i = 0; i < 16; i++)
+                    w[i] = uint32(m[block + 4 * i]) << 24 | uint32(m[block + 4 * i + 1]) << 16 | uint32(m[block + 4 * i + 2]) << 8 | m[block + 4 * i + 3];
+                for (int i = 16; i < 80; i++) w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+                uint32 a = h[0], b = h[1], c = h[2], d = h[3], x = h[4];
+                for (int i = 0; i < 80; i++) {
+                    uint32 f, k;
+                    if (i < 20) { f = (b & c) | (~b & d); k = 0x5a827999; }
+                    else if (i < 40) { f = b ^ c ^ d; k = 0x6ed9eba1; }
+                    else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8f1bbcdc; }
+                    else { f = b ^ c ^ d; k = 0xca62c1d6; }
+                    uint32 t = rotate(a, 5) + f + x + k + w[i];
+                    x = d;
+                    d = c;
+                    c = rotate(b, 30);
+                    b = a;
+                    a = t;
+                }
+                h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += x;
+            }
+
+            e.resize(20);
+            for (int i = 0; i < 20; i++) e[i] = byte(h[i / 4] >> (24 - 8 * (i % 4)));
+        }
+
+        template <typename digest>
+        void assign(element& e, const digest& d) {
+            e.assign(d.begin(), d.end());
+        }
+
+        // every op code that is not a push goes to one of these.
+        enum handler : byte {
+            h_invalid,
+            h_push_number,
+            h_nop,
+            h_if,
+            h_else,
+            h_endif,
+            h_verify,
+            h_return,
+            h_to_alt,
+            h_from_alt,
+            h_2drop,
+            h_2dup,
+            h_3dup,
+            h_2over,
+            h_2rot,
+            h_2swap,
+            h_ifdup,
+            h_depth,
+            h_drop,
+            h_dup,
+            h_nip,
+            h_over,
+            h_pick,
+            h_rot,
+            h_swap,
+            h_tuck,
+            h_cat,
+            h_split,
+            h_num2bin,
+            h_bin2num,
+            h_size,
+            h_bitwise,
+            h_equal,
+            h_unary,
+            h_binary,
+            h_within,
+            h_hash,
+            h_code_separator,
+            h_check_sig,
+            h_check_multisig,
+            h_check_locktime,
+            h_check_sequence
+        };
+
+        constexpr std::array<byte, 256> make_handlers() {
+            std::array<byte, 256> h{};
+            h[program::OP_1NEGATE] = h_push_number;
+            for (int i = program::OP_1; i <= program::OP_16; i++) h[i] = h_push_number;
+            h[program::OP_NOP] = h_nop;
+            h[program::OP_NOP1] = h_nop;
+            for (int i = program::OP_NOP4; i <= program::OP_NOP10; i++) h[i] = h_nop;
+            h[program::OP_IF] = h_if;
+            h[program::OP_NOTIF] = h_if;
+            h[program::OP_ELSE] = h_else;
+            h[program::OP_ENDIF] = h_endif;
+            h[program::OP_VERIFY] = h_verify;
+            h[program::OP_RETURN] = h_return;
+            h[program::OP_TOALTSTACK] = h_to_alt;
+            h[program::OP_FROMALTSTACK] = h_from_alt;
+            h[program::OP_2DROP] = h_2drop;
+            h[program::OP_2DUP] = h_2dup;
+            h[program::OP_3DUP] = h_3dup;
+            h[program::OP_2OVER] = h_2over;
+            h[program::OP_2ROT] = h_2rot;
+            h[program::OP_2SWAP] = h_2swap;
+            h[program::OP_IFDUP] = h_ifdup;
+            h[program::OP_DEPTH] = h_depth;
+            h[program::OP_DROP] = h_drop;
+            h[program::OP_DUP] = h_dup;
+            h[program::OP_NIP] = h_nip;
+            h[program::OP_OVER] = h_over;
+            h[program::OP_PICK] = h_pick;
+            h[program::OP_ROLL] = h_pick;
+            h[program::OP_ROT] = h_rot;
+            h[program::OP_SWAP] = h_swap;
+            h[program::OP_TUCK] = h_tuck;
+            h[program::OP_CAT] = h_cat;
+            h[program::OP_SPLIT] = h_split;
+            h[program::OP_NUM2BIN] = h_num2bin;
+            h[program::OP_BIN2NUM] = h_bin2num;
+            h[program::OP_SIZE] = h_size;
+            h[program::OP_AND] = h_bitwise;
+            h[program::OP_OR] = h_bitwise;
+            h[program::OP_XOR] = h_bitwise;
+            h[program::OP_EQUAL] = h_equal;
+            h[program::OP_EQUALVERIFY] = h_equal;
+            for (int i = program::OP_1ADD; i <= program::OP_0NOTEQUAL; i++) h[i] = h_unary;
+            for (int i = program::OP_ADD; i <= program::OP_MAX; i++) h[i] = h_binary;
+            h[program::OP_WITHIN] = h_within;
+            for (int i = program::OP_RIPEMD160; i <= program::OP_HASH256; i++) h[i] = h_hash;
+            h[program::OP_CODESEPARATOR] = h_code_separator;
+            h[program::OP_CHECKSIG] = h_check_sig;
+            h[program::OP_CHECKSIGVERIFY] = h_check_sig;
+            h[program::OP_CHECKMULTISIG] = h_check_multisig;
+            h[program::OP_CHECKMULTISIGVERIFY] = h_check_multisig;
+            h[program::OP_CHECKLOCKTIMEVERIFY] = h_check_locktime;
+            h[program::OP_CHECKSEQUENCEVERIFY] = h_check_sequence;
+            return h;
+        }
+
+        constexpr std::array<byte, 256> handlers = make_handlers();
+
+        bool unary(op o, int64_t& n) {
+            switch (o) {
+                case program::OP_1ADD: n += 1; return true;
+                case program::OP_1SUB: n -= 1; return true;
+                case program::OP_NEGATE: n = -n; return true;
+                case program::OP_ABS: if (n < 0) n = -n; return true;
+                case program::OP_NOT: n = n == 0; return true;
+                case program::OP_0NOTEQUAL: n = n != 0; return true;
+                default: return false;
+            }
+        }
+
+        bool binary(op o, int64_t a, int64_t b, int64_t& n) {
+            switch (o) {
+                case program::OP_ADD: n = a + b; return true;
+                case program::OP_SUB: n = a - b; return true;
+                case program::OP_DIV: if (b == 0) return false; n = a / b; return true;
+                case program::OP_MOD: if (b == 0) return false; n = a % b; return true;
+                case program::OP_BOOLAND: n = a != 0 && b != 0; return true;
+                case program::OP_BOOLOR: n = a != 0 || b != 0; return true;
+                case program::OP_NUMEQUAL:
+                case program::OP_NUMEQUALVERIFY: n = a == b; return true;
+                case program::OP_NUMNOTEQUAL: n = a != b; return true;
+                case program::OP_LESSTHAN: n = a < b; return true;
+                case program::OP_GREATERTHAN: n = a > b; return true;
+                case program::OP_LESSTHANOREQUAL: n = a <= b; return true;
+                case program::OP_GREATERTHANOREQUAL: n = a >= b; return true;
+                case program::OP_MIN: n = a < b ? a : b; return true;
+                case program::OP_MAX: n = a > b ? a : b; return true;
+                default: return false;
+            }
+        }
+
+        bool evaluate(arena& a, const byte* begin, const byte* end, const interpreter::checker& checker, uint32 flags) {
+#ifdef ABSTRACTIONS_COMPUTED_GOTO
+            static const void* const labels[] = {
+                &&label_h_invalid, &&label_h_push_number, &&label_h_nop, &&label_h_if, &&label_h_else,
+                &&label_h_endif, &&label_h_verify, &&label_h_return, &&label_h_to_alt, &&label_h_from_alt,
+                &&label_h_2drop, &&label_h_2dup, &&label_h_3dup, &&label_h_2over, &&label_h_2rot,
+                &&label_h_2swap, &&label_h_ifdup, &&label_h_depth, &&label_h_drop, &&label_h_dup,
+                &&label_h_nip, &&label_h_over, &&label_h_pick, &&label_h_rot, &&label_h_swap,
+                &&label_h_tuck, &&label_h_cat, &&label_h_split, &&label_h_num2bin, &&label_h_bin2num,
+                &&label_h_size, &&label_h_bitwise, &&label_h_equal, &&label_h_unary, &&label_h_binary,
+                &&label_h_within, &&label_h_hash, &&label_h_code_separator, &&label_h_check_sig, &&label_h_check_multisig,
+                &&label_h_check_locktime, &&label_h_check_sequence};
+            static_assert(sizeof(labels) / sizeof(labels[0]) == h_check_sequence + 1);
+#endif
+            if (N(end - begin) > max_script_size) return false;
+
+            stack& s = a.Main;
+            stack& alt = a.Alt;
+            std::vector<bool>& conditions = a.Conditions;
+            alt.clear();
+            conditions.clear();
+
+            // number of false conditions that we are inside of.
+            N unexecuted = 0;
+            bool minimal = flags & interpreter::verify_minimal_data;
+            const byte* pc = begin;
+            const byte* code = begin;
+            N ops = 0;
+
+            while (pc < end) {
+                bool executing = unexecuted == 0;
+                op o = op(*pc++);
+
+                if (o <= program::OP_PUSHDATA4) {
+                    N n;
+                    if (!read_push(o, pc, end, n) || n > max_element_size) return false;
+                    if (executing) {
+                        if (minimal && !minimal_push(o, pc, n)) return false;
+                        s.push(pc, n);
+                    }
+                    pc += n;
+                    goto next;
+                }
+
+                if (o > program::OP_16 && ++ops > max_ops) return false;
+                if (disabled(o)) return false;
+                if (!executing && (o < program::OP_IF || o > program::OP_ENDIF)) continue;
+
+                dispatch(handlers[o]) {
+                    handle(h_invalid): return false;
+
+                    handle(h_push_number): {
+                        push_number(s, o == program::OP_1NEGATE ? -1 : int64_t(o) - 0x50);
+                    } goto next;
+
+                    handle(h_nop): goto next;
+
+                    handle(h_if): {
+                        bool value = false;
+                        if (executing) {
+                            if (s.size() < 1) return false;
+                            element& e = s.top();
+                            if ((flags & interpreter::verify_minimal_if) && (e.size() > 1 || (e.size() == 1 && e[0] != 1))) return false;
+                            value = to_bool(e) == (o == program::OP_IF);
+                            s.pop();
+                        }
+                        conditions.push_back(value);
+                        if (!value) unexecuted++;
+                    } goto next;
+
+                    handle(h_else): {
+                        if (conditions.empty()) return false;
+                        if (conditions.back()) unexecuted++;
+                        else unexecuted--;
+                        conditions.back() = !conditions.back();
+                    } goto next;
+
+                    handle(h_endif): {
+                        if (conditions.empty()) return false;
+                        if (!conditions.back()) unexecuted--;
+                        conditions.pop_back();
+                    } goto next;
+
+                    handle(h_verify): {
+                        if (s.size() < 1 || !to_bool(s.top())) return false;
+                        s.pop();
+                    } goto next;
+
+                    handle(h_return): return false;
+
+                    handle(h_to_alt): {
+                        if (s.size() < 1) return false;
+                        s.move(alt);
+                    } goto next;
+
+                    handle(h_from_alt): {
+                        if (alt.size() < 1) return false;
+                        alt.move(s);
+                    } goto next;
+
+                    handle(h_2drop): {
+                        if (s.size() < 2) return false;
+                        s.pop(2);
+                    } goto next;
+
+                    handle(h_2dup): {
+                        if (s.size() < 2) return false;
+                        s.copy(1);
+                        s.copy(1);
+                    } goto next;
+
+                    handle(h_3dup): {
+                        if (s.size() < 3) return false;
+                        s.copy(2);
+                        s.copy(2);
+                        s.copy(2);
+                    } goto next;
+
+                    handle(h_2over): {
+                        if (s.size() < 4) return false;
+                        s.copy(3);
+                        s.copy(3);
+                    } goto next;
+
+                    handle(h_2rot): {
+                        if (s.size() < 6) return false;
+                        s.roll(5);
+                        s.roll(5);
+                    } goto next;
+
+                    handle(h_2swap): {
+                        if (s.size() < 4) return false;
+                        s.swap(3, 1);
+                        s.swap(2, 0);
+                    } goto next;
+
+                    handle(h_ifdup): {
+                        if (s.size() < 1) return false;
+                        if (to_bool(s.top())) s.copy(0);
+                    } goto next;
+
+                    handle(h_depth): {
+                        push_number(s, s.size());
+                    } goto next;
+
+                    handle(h_drop): {
+                        if (s.size() < 1) return false;
+                        s.pop();
+                    } goto next;
+
+                    handle(h_dup): {
+                        if (s.size() < 1) return false;
+                        s.copy(0);
+                    } goto next;
+
+                    handle(h_nip): {
+                        if (s.size() < 2) return false;
+                        s.roll(1);
+                        s.pop();
+                    } goto next;
+
+                    handle(h_over): {
+                        if (s.size() < 2) return false;
+                        s.copy(1);
+                    } goto next;
+
+                    handle(h_pick): {
+                        int64_t n;
+                        if (s.size() < 2 || !read_number(s.top(), n, minimal)) return false;
+                        s.pop();
+                        if (n < 0 || N(n) >= s.size()) return false;
+                        if (o == program::OP_PICK) s.copy(n);
+                        else s.roll(n);
+                    } goto next;
+
+                    handle(h_rot): {
+                        if (s.size() < 3) return false;
+                        s.roll(2);
+                    } goto next;
+
+                    handle(h_swap): {
+                        if (s.size() < 2) return false;
+                        s.swap(0, 1);
+                    } goto next;
+
+                    handle(h_tuck): {
+                        if (s.size() < 2) return false;
+                        s.copy(0);
+                        s.swap(1, 2);
+                    } goto next;
+
+                    handle(h_cat): {
+                        if (s.size() < 2) return false;
+                        element& x = s.top(1);
+                        element& y = s.top();
+                        if (x.size() + y.size() > max_element_size) return false;
+                        x.insert(x.end(), y.begin(), y.end());
+                        s.pop();
+                    } goto next;
+
+                    handle(h_split): {
+                        int64_t n;
+                        if (s.size() < 2 || !read_number(s.top(), n, minimal)) return false;
+                        s.pop();
+                        if (n < 0 || N(n) > s.top().size()) return false;
+                        s.split(n);
+                    } goto next;
+
+                    handle(h_num2bin): {
+                        int64_t n;
+                        if (s.size() < 2 || !read_number(s.top(), n, minimal)) return false;
+                        if (n < 0 || N(n) > max_element_size) return false;
+                        s.pop();
+                        element& e = s.top();
+                        minimally_encode(e);
+                        if (e.size() > N(n)) return false;
+                        if (e.size() < N(n)) {
+                            byte sign = 0;
+                            if (!e.empty()) {
+                                sign = e.back() & 0x80;
+                                e.back() &= 0x7f;
+                            }
+                            e.resize(n, 0);
+                            e.back() |= sign;
+                        }
+                    } goto next;
+
+                    handle(h_bin2num): {
+                        if (s.size() < 1) return false;
+                        element& e = s.top();
+                        minimally_encode(e);
+                        if (e.size() > max_number_size) return false;
+                    } goto next;
+
+                    handle(h_size): {
+                        if (s.size() < 1) return false;
+                        push_number(s, s.top().size());
+                    } goto next;
+
+                    handle(h_bitwise): {
+                        if (s.size() < 2) return false;
+                        element& x = s.top(1);
+                        element& y = s.top();
+                        if (x.size() != y.size()) return false;
+                        for (N i = 0; i < x.size(); i++) {
+                            if (o == program::OP_AND) x[i] &= y[i];
+                            else if (o == program::OP_OR) x[i] |= y[i];
+                            else x[i] ^= y[i];
+                        }
+                        s.pop();
+                    } goto next;
+
+                    handle(h_equal): {
+                        if (s.size() < 2) return false;
+                        bool equal = s.top() == s.top(1);
+                        s.pop(2);
+                        if (o == program::OP_EQUALVERIFY) {
+                            if (!equal) return false;
+                        } else push_bool(s, equal);
+                    } goto next;
+
+                    handle(h_unary): {
+                        int64_t n;
+                        if (s.size() < 1 || !read_number(s.top(), n, minimal) || !unary(o, n)) return false;
+                        write_number(n, s.top());
+                    } goto next;
+
+                    handle(h_binary): {
+                        int64_t x, y, n;
+                        if (s.size() < 2 || !read_number(s.top(1), x, minimal) || !read_number(s.top(), y, minimal)) return false;
+                        if (!binary(o, x, y, n)) return false;
+                        s.pop(2);
+                        if (o == program::OP_NUMEQUALVERIFY) {
+                            if (!n) return false;
+                        } else push_number(s, n);
+                    } goto next;
+
+                    handle(h_within): {
+                        int64_t x, min, max;
+                        if (s.size() < 3 || !read_number(s.top(2), x, minimal) ||
+                            !read_number(s.top(1), min, minimal) || !read_number(s.top(), max, minimal)) return false;
+                        s.pop(3);
+                        push_bool(s, min <= x && x < max);
+                    } goto next;
+
+                    handle(h_hash): {
+                        if (s.size() < 1) return false;
+                        element& e = s.top();
+                        switch (o) {
+                            case program::OP_RIPEMD160:
+                                assign(e, ripemd160::hash(e));
+                                break;
+                            case program::OP_SHA1:
+                                sha1(e);
+                                break;
+                            case program::OP_SHA256:
+                                assign(e, sha256::hash(e));
+                                break;
+                            case program::OP_HASH160: {
+                                const sha256::digest d = sha256::hash(e);
+                                assign(e, ripemd160::hash<32>(static_cast<const std::array<byte, 32>&>(d)));
+                                break;
+                            }
+                            default:
+                                assign(e, sha256::double_hash(e));
+                        }
+                    } goto next;
+
+                    handle(h_code_separator): {
+                        code = pc;
+                    } goto next;
+
+                    handle(h_check_sig): {
+                        if (s.size() < 2) return false;
+                        element& sig = s.top(1);
+                        element& pubkey = s.top();
+                        if (!valid_signature_encoding(sig, flags) || !valid_pubkey_encoding(pubkey, flags)) return false;
+                        a.Code.assign(code, end);
+                        if (deleted(sig, flags)) find_and_delete(a.Code, sig);
+                        bool valid = !sig.empty() && checker.check_signature(sig, pubkey, a.Code);
+                        if (!valid && (flags & interpreter::verify_null_fail) && !sig.empty()) return false;
+                        s.pop(2);
+                        if (o == program::OP_CHECKSIGVERIFY) {
+                            if (!valid) return false;
+                        } else push_bool(s, valid);
+                    } goto next;
+
+                    handle(h_check_multisig): {
+                        int64_t keys, sigs;
+                        N i = 1;
+                        if (s.size() < i || !read_number(s.top(i - 1), keys, minimal)) return false;
+                        if (keys < 0 || keys > max_pubkeys) return false;
+                        ops += keys;
+                        if (ops > max_ops) return false;
+                        N key = ++i;
+                        i += keys;
+                        N remaining = keys + 2;
+                        if (s.size() < i || !read_number(s.top(i - 1), sigs, minimal)) return false;
+                        if (sigs < 0 || sigs > keys) return false;
+                        N sig = ++i;
+                        i += sigs;
+                        if (s.size() < i) return false;
+
+                        a.Code.assign(code, end);
+                        for (N k = 0; k < N(sigs); k++) {
+                            element& x = s.top(sig + k - 1);
+                            if (deleted(x, flags)) find_and_delete(a.Code, x);
+                        }
+
+                        bool valid = true;
+                        while (valid && sigs > 0) {
+                            element& x = s.top(sig - 1);
+                            element& p = s.top(key - 1);
+                            if (!valid_signature_encoding(x, flags) || !valid_pubkey_encoding(p, flags)) return false;
+                            if (!x.empty() && checker.check_signature(x, p, a.Code)) {
+                                sig++;
+                                sigs--;
+                            }
+                            key++;
+                            keys--;
+                            if (sigs > keys) valid = false;
+                        }
+
+                        while (i-- > 1) {
+                            if (!valid && (flags & interpreter::verify_null_fail) && !remaining && !s.top().empty()) return false;
+                            if (remaining > 0) remaining--;
+                            s.pop();
+                        }
+
+                        // the extra element that Satoshi's implementation consumes by mistake.
+                        if (s.size() < 1) return false;
+                        if ((flags & interpreter::verify_null_dummy) && !s.top().empty()) return false;
+                        s.pop();
+
+                        if (o == program::OP_CHECKMULTISIGVERIFY) {
+                            if (!valid) return false;
+                        } else push_bool(s, valid);
+                    } goto next;
+
+                    handle(h_check_locktime): {
+                        if (!(flags & interpreter::verify_locktime)) goto next;
+                        int64_t n;
+                        if (s.size() < 1 || !read_number(s.top(), n, minimal, 5)) return false;
+                        if (n < 0 || !checker.check_locktime(n)) return false;
+                    } goto next;
+
+                    handle(h_check_sequence): {
+                        if (!(flags & interpreter::verify_sequence)) goto next;
+                        int64_t n;
+                        if (s.size() < 1 || !read_number(s.top(), n, minimal, 5)) return false;
+                        if (n < 0) return false;
+                        if ((n & (int64_t(1) << 31)) == 0 && !checker.check_sequence(n)) return false;
+                    } goto next;
+                }
+
+            next:
+                if (s.size() + alt.size() > max_stack_size) return false;
+            }
+
+            return conditions.empty();
+        }
+
+        bool evaluate(arena& a, bytes& script, const interpreter::checker& c, uint32 flags) {
+            return evaluate(a, script.data(), script.data() + script.size(), c, flags);
+        }
+
+    }
+
+    bool interpreter::run(bytes& output, bytes& input) const {
+        arena& a = Arena;
+        if ((Flags & verify_push_only) && !push_only(input)) return false;
+
+        a.Main.clear();
+        if (!evaluate(a, input, *Checker, Flags)) return false;
+
+        bool p2sh = (Flags & verify_p2sh) && pay_to_script_hash(output);
+        if (p2sh) {
+            a.Saved.clear();
+            for (N i = a.Main.size(); i > 0; i--) a.Saved.push() = a.Main.top(i - 1);
+        }
+
+        if (!evaluate(a, output, *Checker, Flags)) return false;
+        if (a.Main.size() == 0 || !to_bool(a.Main.top())) return false;
+
+        if (p2sh) {
+            if (!push_only(input)) return false;
+            std::swap(a.Main, a.Saved);
+            if (a.Main.size() == 0) return false;
+            std::swap(a.Redeem, a.Main.top());
+            a.Main.pop();
+            if (!evaluate(a, a.Redeem, *Checker, Flags)) return false;
+            if (a.Main.size() == 0 || !to_bool(a.Main.top())) return false;
+        }
+
+        if ((Flags & verify_clean_stack) && a.Main.size() != 1) return false;
+        return true;
+    }
+
+}
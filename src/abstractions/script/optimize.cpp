@@ -0,0 +1,204 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/script/optimize.hpp>
+
+namespace abstractions::script {
+    
+    namespace {
+        
+        using op = program::op;
+        
+        // no element on the stack may be larger than this. 
+        const N max_element_size = 520;
+        
+        // an instruction in which every push is a constant. The op code 
+        // of a push is kept so that it can be written as it was. 
+        struct step {
+            op Code;
+            bool Constant;
+            std::vector<byte> Data;
+        };
+        
+        step constant(op code, std::vector<byte> data) {
+            return step{code, true, data};
+        }
+        
+        // a constant that was worked out ahead of time is written in its smallest form. 
+        void compute(step& s, std::vector<byte> data) {
+            s.Code = flat::push_code(data.data(), data.size());
+            s.Data = data;
+        }
+        
+        // op codes that push a number without any data after them. 
+        bool small_number(op o) {
+            return o == program::OP_0 || o == program::OP_1NEGATE || (o >= program::OP_1 && o <= program::OP_16);
+        }
+        
+        std::vector<byte> small_number_value(op o) {
+            if (o == program::OP_0) return {};
+            if (o == program::OP_1NEGATE) return {0x81};
+            return {byte(o - 0x50)};
+        }
+        
+        // read a minimally encoded script number of at most four bytes. 
+        bool read_number(const std::vector<byte>& b, int64_t& n) {
+            if (b.size() > 4) return false;
+            if (b.size() > 0 && (b.back() & 0x7f) == 0 && (b.size() == 1 || !(b[b.size() - 2] & 0x80))) return false;
+            uint64 m = 0;
+            for (N i = 0; i < b.size(); i++) m |= uint64(b[i]) << (8 * i);
+            if (b.size() > 0 && (b.back() & 0x80)) {
+                m &= ~(uint64(0x80) << (8 * (b.size() - 1)));
+                n = -int64_t(m);
+            } else n = int64_t(m);
+            return true;
+        }
+        
+        std::vector<byte> write_number(int64_t n) {
+            std::vector<byte> b;
+            uint64 m = n < 0 ? uint64(-n) : uint64(n);
+            for (; m > 0; m >>= 8) b.push_back(byte(m));
+            if (b.empty()) return b;
+            if (b.back() & 0x80) b.push_back(n < 0 ? 0x80 : 0);
+            else if (n < 0) b.back() |= 0x80;
+            return b;
+        }
+        
+        // the op code that does o and then OP_VERIFY, or OP_0 if there is none. 
+        op verify_form(op o) {
+            switch (o) {
+                case program::OP_EQUAL: return program::OP_EQUALVERIFY;
+                case program::OP_NUMEQUAL: return program::OP_NUMEQUALVERIFY;
+                case program::OP_CHECKSIG: return program::OP_CHECKSIGVERIFY;
+                case program::OP_CHECKMULTISIG: return program::OP_CHECKMULTISIGVERIFY;
+                default: return program::OP_0;
+            }
+        }
+        
+        // operations on the top two elements that do not depend on their order. 
+        bool symmetric(op o) {
+            switch (o) {
+                case program::OP_AND: 
+                case program::OP_OR: 
+                case program::OP_XOR: 
+                case program::OP_EQUAL: 
+                case program::OP_EQUALVERIFY: 
+                case program::OP_ADD: 
+                case program::OP_BOOLAND: 
+                case program::OP_BOOLOR: 
+                case program::OP_NUMEQUAL: 
+                case program::OP_NUMEQUALVERIFY: 
+                case program::OP_NUMNOTEQUAL: 
+                case program::OP_MIN: 
+                case program::OP_MAX: 
+                    return true;
+                default: 
+                    return false;
+            }
+        }
+        
+        // whether the n steps before the last are constants which can be 
+        // pushed. A push that is too large fails the script, as does one 
+        // that is not in its smallest form if minimal data is required, 
+        // so neither must ever be rewritten away. 
+        bool constants(const std::vector<step>& s, N n) {
+            if (s.size() < n + 1) return false;
+            for (N i = s.size() - n - 1; i < s.size() - 1; i++) 
+                if (!s[i].Constant || s[i].Data.size() > max_element_size || 
+                    s[i].Code != flat::push_code(s[i].Data.data(), s[i].Data.size())) return false;
+            return true;
+        }
+        
+        // try to rewrite the end of the program and return whether anything changed. 
+        bool rewrite(std::vector<step>& s) {
+            N size = s.size();
+            if (size < 2 || s.back().Constant) return false;
+            op last = s.back().Code;
+            step& previous = s[size - 2];
+            
+            if (last == program::OP_VERIFY && !previous.Constant && verify_form(previous.Code) != program::OP_0) {
+                previous.Code = verify_form(previous.Code);
+                s.pop_back();
+                return true;
+            }
+            
+            if (symmetric(last) && !previous.Constant && previous.Code == program::OP_SWAP) {
+                s.erase(s.end() - 2);
+                return true;
+            }
+            
+            if (last == program::OP_DROP && constants(s, 1)) {
+                s.resize(size - 2);
+                return true;
+            }
+            
+            if (!constants(s, 2)) return false;
+            step& x = s[size - 3];
+            step& y = s[size - 2];
+            
+            switch (last) {
+                case program::OP_2DROP: 
+                    s.resize(size - 3);
+                    return true;
+                case program::OP_SWAP: 
+                    std::swap(x, y);
+                    s.pop_back();
+                    return true;
+                case program::OP_CAT: {
+                    if (x.Data.size() + y.Data.size() > max_element_size) return false;
+                    std::vector<byte> joined = x.Data;
+                    joined.insert(joined.end(), y.Data.begin(), y.Data.end());
+                    compute(x, joined);
+                    s.resize(size - 2);
+                    return true;
+                }
+                case program::OP_SPLIT: {
+                    int64_t n;
+                    if (!read_number(y.Data, n) || n < 0 || N(n) > x.Data.size()) return false;
+                    std::vector<byte> whole = x.Data;
+                    compute(x, std::vector<byte>(whole.begin(), whole.begin() + n));
+                    compute(y, std::vector<byte>(whole.begin() + n, whole.end()));
+                    s.pop_back();
+                    return true;
+                }
+                case program::OP_ADD: 
+                case program::OP_SUB: {
+                    int64_t a, b;
+                    if (!read_number(x.Data, a) || !read_number(y.Data, b)) return false;
+                    compute(x, write_number(last == program::OP_ADD ? a + b : a - b));
+                    s.resize(size - 2);
+                    return true;
+                }
+                default: 
+                    return false;
+            }
+        }
+        
+    }
+    
+    optimized optimize(const program& p) {
+        flat f{p.compile()};
+        if (!f.valid()) return optimized{f, f.length()};
+        
+        std::vector<step> s;
+        s.reserve(f.Instructions.size());
+        for (const flat::instruction& i : f.Instructions) {
+            if (flat::is_push(i.Code)) s.push_back(constant(i.Code, std::vector<byte>(f.Data.begin() + i.Offset, f.Data.begin() + i.Offset + i.Size)));
+            else if (small_number(i.Code)) s.push_back(constant(i.Code, small_number_value(i.Code)));
+            else s.push_back(step{i.Code, false, {}});
+            while (rewrite(s));
+        }
+        
+        flat o{};
+        o.reserve(s.size(), f.Data.size());
+        for (const step& x : s) {
+            if (x.Constant && flat::is_push(x.Code)) o.push(x.Code, x.Data.data(), x.Data.size());
+            else o.emit(x.Code);
+        }
+        
+        // whatever the rewrites did, never return something longer. 
+        if (o.length() > f.length()) return optimized{f, f.length()};
+        return optimized{o, f.length()};
+    }
+    
+}
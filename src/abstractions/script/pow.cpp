@@ -5,9 +5,15 @@
 
 namespace abstractions::script {
         
-        pointer<program> push_pow_target(work::target);
+        pointer<program> push_pow_target(work::target t) {
+            std::vector<byte> x(4);
+            for (int i = 0; i < 4; i++) x[i] = byte(uint32(t) >> (8 * i));
+            return push_data(x);
+        }
         
-        pointer<program> push_zero_bytes(uint32);
+        pointer<program> push_zero_bytes(uint32 n) {
+            return push_data(std::vector<byte>(n, 0));
+        }
         
         pointer<program> expand_target() {
             return sequence({
@@ -23,6 +29,21 @@ namespace abstractions::script {
             });
         }
         
+        // the part of lock_by_pow after the target, which has no data in it. 
+        pointer<program> pow_lock_epilogue() {
+            return sequence({
+                dup(), 
+                to_alt(),
+                concat(5),
+                rotate_bytes_left(4),
+                bitcoin_hash(),
+                from_alt(),          // retrieve target. 
+                expand_target(), 
+                less_256_verify(),
+                check_signature()
+            });
+        }
+        
         pointer<program> lock_by_pow(sha256::digest m, work::target t) {
             // The input that redeems this script will push a signature, a nonce, and a pubkey. 
             return sequence({
@@ -34,16 +55,18 @@ namespace abstractions::script {
                 dup(),               // need two pubkeys. 
                 to_alt(), 
                 push_pow_target(t),
-                dup(), 
-                to_alt(),
-                concat(5),
-                rotate_bytes_left(4),
-                bitcoin_hash(),
-                from_alt(),          // retrieve target. 
-                expand_target(), 
-                less_256_verify(),
-                check_signature()
+                pow_lock_epilogue()
             });
         }
+        
+        bytes templates::lock_by_pow(const sha256::digest& m, work::target t) {
+            static const std::vector<byte> epilogue = pow_lock_epilogue()->compile();
+            std::vector<byte> b(pow_lock_prologue.Skeleton.size() + epilogue.size());
+            std::copy(epilogue.begin(), epilogue.end(), pow_lock_prologue.write(b.data()));
+            std::array<byte, 4> x;
+            for (int i = 0; i < 4; i++) x[i] = byte(uint32(t) >> (8 * i));
+            pow_lock_prologue.fill(b.data(), 0, m);
+            pow_lock_prologue.fill(b.data(), 1, x);
+            return b;
+        }
 }
-
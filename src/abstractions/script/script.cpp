@@ -6,10 +6,11 @@
 namespace abstractions::script {
     const boost::endian::order ENDIANESS=boost::endian::order::little;
     
+    // The size is computed first so that exactly one allocation 
+    // is needed, and then the program is written in one pass. 
     bytes program::compile() const {
-        std::vector<byte> b{static_cast<unsigned char>(length())};
-        data::slice_writer s{b,ENDIANESS};
-        write(s);
+        std::vector<byte> b(length());
+        write(b.data());
         return b;
     };
 }
@@ -0,0 +1,267 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/select.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace abstractions::select {
+
+    namespace {
+
+        const N max_tries = 100000;
+
+        // how much work the knapsack does at most.
+        const N knapsack_steps = 5000000;
+        const N knapsack_iterations = 1000;
+
+        struct candidate {
+            N Index;
+            int64_t Effective;
+        };
+
+        int64_t input_fee(const options& o) {
+            return o.fee(o.InputSize);
+        }
+
+        // the amount that the inputs must be worth, including the fee
+        // for everything but the inputs themselves.
+        int64_t target(satoshi amount, const options& o) {
+            return amount + o.fee_for_inputs(0);
+        }
+
+        // outputs that are worth something, most valuable first.
+        std::vector<candidate> candidates(const std::vector<satoshi>& values, const options& o) {
+            std::vector<candidate> c{};
+            c.reserve(values.size());
+            int64_t fee = input_fee(o);
+            for (N i = 0; i < values.size(); i++)
+                if (int64_t(values[i]) > fee) c.push_back(candidate{i, int64_t(values[i]) - fee});
+            if (std::is_sorted(values.begin(), values.end(), std::greater<satoshi>{})) return c;
+            std::sort(c.begin(), c.end(), [](const candidate& a, const candidate& b) -> bool {
+                return a.Effective != b.Effective ? a.Effective > b.Effective : a.Index < b.Index;
+            });
+            return c;
+        }
+
+        selection finish(const std::vector<satoshi>& values, std::vector<N> inputs, satoshi amount, const options& o, bool change) {
+            selection s{};
+            satoshi value = 0;
+            for (N i : inputs) value += values[i];
+
+            N n = inputs.size();
+            satoshi fee = o.fee_for_inputs(n);
+            if (n == 0 || value < amount + fee) return s;
+
+            satoshi excess = value - amount - fee;
+            int64_t waste = n * (int64_t(input_fee(o)) - int64_t(o.LongTermFeeRate * o.InputSize / 1000));
+
+            satoshi change_fee = o.fee(o.ChangeSize);
+            if (change && excess >= change_fee + o.Dust) {
+                s.Change = excess - change_fee;
+                s.Fee = fee + change_fee;
+                s.Waste = waste + o.cost_of_change();
+            } else {
+                s.Fee = fee + excess;
+                s.Waste = waste + excess;
+            }
+
+            std::sort(inputs.begin(), inputs.end());
+            s.Inputs = inputs;
+            s.Value = value;
+            return s;
+        }
+
+        // xorshift, so that results do not depend on the library.
+        struct random {
+            uint64 State;
+
+            uint64 operator()() {
+                State ^= State << 13;
+                State ^= State >> 7;
+                State ^= State << 17;
+                return State;
+            }
+        };
+
+    }
+
+    selection branch_and_bound(const std::vector<satoshi>& values, satoshi amount, const options& o) {
+        std::vector<candidate> c = candidates(values, o);
+        const int64_t low = target(amount, o);
+        const int64_t high = low + o.cost_of_change();
+        const int64_t input_waste = input_fee(o) - int64_t(o.LongTermFeeRate * o.InputSize / 1000);
+
+        int64_t remaining = 0;
+        for (const candidate& x : c) remaining += x.Effective;
+        if (remaining < low) return {};
+
+        // whether each candidate up to the current depth is included.
+        std::vector<bool> included{};
+        included.reserve(c.size());
+        int64_t value = 0;
+        int64_t waste = 0;
+
+        std::vector<bool> best{};
+        int64_t best_waste = 0;
+        bool found = false;
+
+        for (N tries = 0; tries < max_tries; tries++) {
+            bool back = false;
+            if (value + remaining < low || value > high || (found && input_waste > 0 && waste > best_waste)) back = true;
+            else if (value >= low) {
+                int64_t total = waste + value - low;
+                if (!found || total <= best_waste) {
+                    best = included;
+                    best_waste = total;
+                    found = true;
+                }
+                back = true;
+            }
+
+            if (back) {
+                // forget the candidates that were left out at the end and
+                // then leave out the last one that was included.
+                while (!included.empty() && !included.back()) {
+                    included.pop_back();
+                    remaining += c[included.size()].Effective;
+                }
+                if (included.empty()) break;
+                included.back() = false;
+                value -= c[included.size() - 1].Effective;
+                waste -= input_waste;
+                continue;
+            }
+
+            N i = included.size();
+            remaining -= c[i].Effective;
+            // there is no point in trying an output in place of
+            // an equal one that has already been left out.
+            if (i > 0 && !included[i - 1] && c[i - 1].Effective == c[i].Effective) included.push_back(false);
+            else {
+                included.push_back(true);
+                value += c[i].Effective;
+                waste += input_waste;
+            }
+        }
+
+        if (!found) return {};
+        std::vector<N> inputs{};
+        for (N i = 0; i < best.size(); i++) if (best[i]) inputs.push_back(c[i].Index);
+        return finish(values, inputs, amount, o, false);
+    }
+
+    selection largest_first(const std::vector<satoshi>& values, satoshi amount, const options& o) {
+        std::vector<candidate> c = candidates(values, o);
+        const int64_t low = target(amount, o);
+        int64_t value = 0;
+        std::vector<N> inputs{};
+        for (const candidate& x : c) {
+            inputs.push_back(x.Index);
+            value += x.Effective;
+            if (value >= low) return finish(values, inputs, amount, o, true);
+        }
+        return {};
+    }
+
+    selection knapsack(const std::vector<satoshi>& values, satoshi amount, const options& o, uint64 seed) {
+        std::vector<candidate> c = candidates(values, o);
+        const int64_t low = target(amount, o);
+
+        // the smallest output that pays for everything alone
+        // and the outputs which are smaller than that.
+        const candidate* larger = nullptr;
+        std::vector<candidate> smaller{};
+        int64_t total = 0;
+        for (const candidate& x : c) {
+            if (x.Effective >= low) larger = &x;
+            else {
+                smaller.push_back(x);
+                total += x.Effective;
+            }
+        }
+
+        // with nothing smaller, only larger can be used. 
+        std::vector<N> inputs{};
+        if (total < low || smaller.empty()) {
+            if (larger != nullptr) inputs.push_back(larger->Index);
+            return finish(values, inputs, amount, o, true);
+        }
+
+        std::vector<char> included(smaller.size());
+        random r{seed ^ 0x2545f4914f6cdd1d};
+
+        // First include outputs at random and then the rest in order.
+        // found is called whenever the amount is reached, after which
+        // the last output is taken out again unless found returns true.
+        auto attempt = [&](auto found) {
+            std::fill(included.begin(), included.end(), 0);
+            int64_t value = 0;
+            bool reached = false;
+            for (int pass = 0; pass < 2 && !reached; pass++)
+                for (N i = 0; i < smaller.size(); i++) {
+                    if (pass == 0 ? (r() & 1) == 0 : included[i]) continue;
+                    value += smaller[i].Effective;
+                    included[i] = 1;
+                    if (value >= low) {
+                        reached = true;
+                        if (found(pass, i, value)) return;
+                        value -= smaller[i].Effective;
+                        included[i] = 0;
+                    }
+                }
+        };
+
+        // rather than copy the outputs included every time we do better,
+        // remember where it happened and repeat the attempt at the end.
+        int64_t best_value = total;
+        bool improved = false;
+        uint64 best_state = 0;
+        int best_pass = 0;
+        N best_i = 0;
+
+        N iterations = std::min(knapsack_iterations, std::max(N(1), knapsack_steps / smaller.size()));
+        for (N n = 0; n < iterations && best_value != low; n++) {
+            uint64 state = r.State;
+            attempt([&](int pass, N i, int64_t value) -> bool {
+                if (value < best_value) {
+                    best_value = value;
+                    improved = true;
+                    best_state = state;
+                    best_pass = pass;
+                    best_i = i;
+                }
+                return false;
+            });
+        }
+
+        if (larger != nullptr && best_value != low && larger->Effective <= best_value) {
+            inputs.push_back(larger->Index);
+            return finish(values, inputs, amount, o, true);
+        }
+
+        if (improved) {
+            r.State = best_state;
+            attempt([&](int pass, N i, int64_t) -> bool {
+                return pass == best_pass && i == best_i;
+            });
+        } else std::fill(included.begin(), included.end(), 1);
+
+        for (N i = 0; i < smaller.size(); i++) if (included[i]) inputs.push_back(smaller[i].Index);
+        return finish(values, inputs, amount, o, true);
+    }
+
+    selection coins(const std::vector<satoshi>& values, satoshi amount, const options& o) {
+        selection exact = branch_and_bound(values, amount, o);
+        if (exact.valid()) return exact;
+
+        selection a = largest_first(values, amount, o);
+        selection b = knapsack(values, amount, o);
+        if (!a.valid()) return b;
+        if (!b.valid()) return a;
+        if (a.Waste != b.Waste) return a.Waste < b.Waste ? a : b;
+        return a.Inputs.size() <= b.Inputs.size() ? a : b;
+    }
+
+}
@@ -2,6 +2,7 @@
 // Distributed under the Open BSV software license, see the accompanying file LICENSE.
 
 #include <abstractions/transaction.hpp>
+#include <abstractions/serialize.hpp>
 
 namespace abstractions {
     
@@ -96,7 +97,7 @@ namespace abstractions {
         o.Valid = o.Reference.valid();
     }
     
-    template <typename txid> void write_outpoint(writer w, typename outpoint<txid>::representation& o) {
+    template <typename txid> void write_outpoint(writer w, const typename outpoint<txid>::representation& o) {
         if (!o.valid()) throw invalid_value{};
         w << o.Reference;
         w << o.Index;
@@ -108,7 +109,7 @@ namespace abstractions {
         o.Valid = o.ScriptPubKey.valid();
     }
     
-    template <typename ops> void write_output(writer w, typename output<ops>::representation& o) {
+    template <typename ops> void write_output(writer w, const typename output<ops>::representation& o) {
         if (!o.valid()) throw invalid_value{};
         w << o.Value;
         write_script(w, o.ScriptPubKey);
@@ -191,10 +192,10 @@ namespace abstractions {
         }
     }
     
-    template <typename txid> outpoint<txid>::outpoint(const representation& o) noexcept : std::vector<byte>{serialized_size(o)} {
+    template <typename txid> outpoint<txid>::outpoint(const representation& o) noexcept : serialized(serialized_size(o)), Representation{o} {
         try {
-            writer w{static_cast<std::vector<byte>&>(o)};
-            write_outpoint(w, *this);
+            writer w{static_cast<std::vector<byte>&>(*this)};
+            write_outpoint<txid>(w, o);
         } catch (...) {
             *this = {};
         }
@@ -209,10 +210,10 @@ namespace abstractions {
         }
     }
     
-    template <typename ops> output<ops>::output(const representation& o) noexcept : std::vector<byte>{serialized_size(o)} {
+    template <typename ops> output<ops>::output(const representation& o) noexcept : serialized(serialized_size(o)), Representation{o} {
         try {
-            writer w{static_cast<std::vector<byte>&>(o)};
-            write_output(w, *this);
+            writer w{static_cast<std::vector<byte>&>(*this)};
+            write_output<ops>(w, o);
         } catch (...) {
             *this = {};
         }
@@ -227,10 +228,10 @@ namespace abstractions {
         }
     }
         
-    template <typename txid, typename ops> input<txid, ops>::input(const representation& i) noexcept : std::vector<byte>{serialized_size(i)} {
+    template <typename txid, typename ops> input<txid, ops>::input(const representation& i) noexcept : serialized(serialized_size(i)), Representation{i} {
         try {
-            writer w{static_cast<std::vector<byte>&>(i)};
-            write_input(w, *this);
+            writer w{static_cast<std::vector<byte>&>(*this)};
+            write_input<txid, ops>(w, i);
         } catch (...) {
             *this = {};
         }
@@ -247,14 +248,8 @@ namespace abstractions {
     }
         
     template <typename in, typename out>
-    transaction<in, out>::transaction(const representation& t) noexcept : std::vector<byte>{serialized_size(t)} {
-        try {
-            writer w{static_cast<std::vector<byte>&>(t)};
-            write_transaction(w, *this);
-        } catch (...) {
-            *this = {};
-        }
-    }
+    transaction<in, out>::transaction(const representation& t) noexcept : 
+        serialized{t.valid() ? serialize::write(t) : std::vector<byte>{}}, Representation{t} {}
     
     template <typename txid>
     typename outpoint<txid>::representation&
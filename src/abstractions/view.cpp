@@ -0,0 +1,233 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/view.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace abstractions::view {
+
+    namespace {
+
+        const N outpoint_size = 36;
+        const N header_size = 80;
+
+        // positions are kept in 32 bits, so nothing is read past this.
+        const N max_size = 0xffffffff;
+
+        // the smallest possible input and output.
+        const N min_input_size = outpoint_size + 5;
+        const N min_output_size = 9;
+
+        uint64 read_little(const byte* b, N size) {
+            uint64 x = 0;
+            for (N i = 0; i < size; i++) x += uint64(b[i]) << (8 * i);
+            return x;
+        }
+
+        uint64 load(const byte* b) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            uint64 x;
+            std::memcpy(&x, b, 8);
+            return x;
+#else
+            return read_little(b, 8);
+#endif
+        }
+
+        // reads through serialized transactions without copying anything.
+        struct cursor {
+            const byte* Begin;
+            N At;
+            N End;
+
+            bool skip(N n) {
+                if (End - At < n) return false;
+                At += n;
+                return true;
+            }
+
+            // when there is room to load the largest var int, it is
+            // read without branching on its size.
+            bool var_int(N& n) {
+                if (End - At >= 9) {
+                    byte b = Begin[At];
+                    N size = b < 0xfd ? 0 : N(1) << (b - 0xfc);
+                    uint64 x = load(Begin + At + 1);
+                    uint64 mask = size == 8 ? ~uint64(0) : (uint64(1) << (8 * size)) - 1;
+                    n = size == 0 ? b : x & mask;
+                    At += size + 1;
+                    return true;
+                }
+
+                if (At == End) return false;
+                byte b = Begin[At++];
+                N size = b < 0xfd ? 0 : N(1) << (b - 0xfc);
+                if (size == 0) {
+                    n = b;
+                    return true;
+                }
+                if (End - At < size) return false;
+                n = read_little(Begin + At, size);
+                At += size;
+                return true;
+            }
+
+            // read one transaction, adding its inputs and outputs to
+            // the tables and the values of its outputs if given.
+            bool transaction(std::vector<position>& in, std::vector<position>& out, std::vector<satoshi>* values) {
+                N inputs, outputs;
+
+                if (!skip(4) || !var_int(inputs)) return false;
+                // a bad count cannot make us reserve a lot of memory.
+                if (inputs > (End - At) / min_input_size) return false;
+                in.reserve(in.size() + inputs);
+                for (N i = 0; i < inputs; i++) {
+                    N offset = At;
+                    N size;
+                    if (!skip(outpoint_size) || !var_int(size)) return false;
+                    N script = At;
+                    if (!skip(size) || !skip(4)) return false;
+                    in.push_back(position{uint32(offset), uint32(script), uint32(size)});
+                }
+
+                if (!var_int(outputs)) return false;
+                if (outputs > (End - At) / min_output_size) return false;
+                out.reserve(out.size() + outputs);
+                for (N i = 0; i < outputs; i++) {
+                    N offset = At;
+                    N size;
+                    if (!skip(8) || !var_int(size)) return false;
+                    N script = At;
+                    if (!skip(size)) return false;
+                    out.push_back(position{uint32(offset), uint32(script), uint32(size)});
+                    if (values != nullptr) values->push_back(satoshi(load(Begin + offset)));
+                }
+
+                return skip(4);
+            }
+        };
+
+        input read_input(slice<byte> data, const position& p) {
+            return input{
+                data.range(p.Offset, p.Offset + outpoint_size),
+                data.range(p.Script, p.Script + p.ScriptSize),
+                uint32(read_little(data.data() + p.Script + p.ScriptSize, 4))};
+        }
+
+        output read_output(slice<byte> data, const position& p) {
+            return output{
+                satoshi(read_little(data.data() + p.Offset, 8)),
+                data.range(p.Script, p.Script + p.ScriptSize)};
+        }
+
+    }
+
+    transaction::transaction(slice<byte> b) : Data{b}, Valid{false}, Size{0}, Inputs{}, Outputs{} {
+        cursor c{Data.data(), 0, std::min(N(Data.size()), max_size)};
+        if (!c.transaction(Inputs, Outputs, nullptr)) return;
+        Size = c.At;
+        Valid = true;
+    }
+
+    int32 transaction::version() const {
+        if (!Valid) return 0;
+        return int32(read_little(Data.data(), 4));
+    }
+
+    uint32 transaction::locktime() const {
+        if (!Valid) return 0;
+        return uint32(read_little(Data.data() + Size - 4, 4));
+    }
+
+    input transaction::input(N i) const {
+        if (i >= Inputs.size()) return view::input{};
+        return read_input(Data, Inputs[i]);
+    }
+
+    output transaction::output(N i) const {
+        if (i >= Outputs.size()) return view::output{};
+        return read_output(Data, Outputs[i]);
+    }
+
+    slice<byte> transaction::serialized_outputs() const {
+        if (Outputs.empty()) return slice<byte>{};
+        const position& last = Outputs.back();
+        return Data.range(Outputs.front().Offset, last.Script + last.ScriptSize);
+    }
+
+    block::block(slice<byte> b) : Data{b}, Valid{false}, Transactions{}, FirstInputs{}, FirstOutputs{}, Inputs{}, Outputs{}, Values{} {
+        if (Data.size() > max_size) return;
+        cursor c{Data.data(), 0, Data.size()};
+        N count;
+        if (!c.skip(header_size) || !c.var_int(count)) return;
+        // a transaction is at least 60 bytes.
+        if (count > (c.End - c.At) / 60) return;
+
+        Transactions.reserve(count + 1);
+        FirstInputs.reserve(count);
+        FirstOutputs.reserve(count);
+
+        for (N t = 0; t < count; t++) {
+            Transactions.push_back(uint32(c.At));
+            FirstInputs.push_back(uint32(Inputs.size()));
+            FirstOutputs.push_back(uint32(Outputs.size()));
+            if (!c.transaction(Inputs, Outputs, &Values)) return;
+        }
+        Transactions.push_back(uint32(c.At));
+
+        Valid = c.At == c.End;
+    }
+
+    slice<byte> block::header() const {
+        if (!Valid) return slice<byte>{};
+        return Data.range(0, header_size);
+    }
+
+    slice<byte> block::transaction(N t) const {
+        if (t >= transactions()) return slice<byte>{};
+        return Data.range(Transactions[t], Transactions[t + 1]);
+    }
+
+    input block::input(N i) const {
+        if (i >= Inputs.size()) return view::input{};
+        return read_input(Data, Inputs[i]);
+    }
+
+    output block::output(N i) const {
+        if (i >= Outputs.size()) return view::output{};
+        return read_output(Data, Outputs[i]);
+    }
+
+    block_file::block_file(string& path, uint32 magic) : File{}, Data{nullptr}, Size{0}, Blocks{} {
+        // boost throws if the file cannot be mapped, which
+        // includes when it is empty.
+        try {
+            File.open(path);
+        } catch (const std::exception&) {
+            return;
+        }
+        if (!File.is_open() || File.size() == 0) return;
+
+        // the mapping is read only, and nothing writes through Data.
+        Data = reinterpret_cast<byte*>(const_cast<char*>(File.data()));
+        Size = File.size();
+
+        // files are allocated ahead of time and filled with zeros, so
+        // the blocks end at the first record without the magic number.
+        N at = 0;
+        while (Size - at >= 8 && read_little(Data + at, 4) == magic) {
+            N size = read_little(Data + at + 4, 4);
+            if (Size - at - 8 < size) break;
+            Blocks.push_back(record{at + 8, size});
+            at += 8 + size;
+        }
+    }
+
+    slice<byte> block_file::serialized(N b) const {
+        if (b >= Blocks.size()) return slice<byte>{};
+        return slice<byte>{Data + Blocks[b].Offset, Blocks[b].Size};
+    }
+
+}
@@ -3,12 +3,53 @@
 
 #include <abstractions/wallet.hpp>
 #include <abstractions/redeem.hpp>
+#include <abstractions/serialize.hpp>
 
 #include <data/for_each.hpp>
 #include <data/fold.hpp>
 
 namespace abstractions {
     
+    template <
+        typename key,
+        typename tag,
+        typename script,
+        typename out, 
+        typename point, 
+        typename tx>
+    funds<key, tag, script, out, point, tx>& 
+    funds<key, tag, script, out, point, tx>::update(const cached& t) {
+        for (const auto& i : t.transaction().inputs()) Entries.remove(i.Outpoint);
+        
+        const auto& id = t.id();
+        index n = 0;
+        for (const out& o : t.transaction().outputs()) {
+            for (recognizable r : Recognize) {
+                tag addr = r.tag(o.ScriptPubKey);
+                if (addr != tag{}) {
+                    Entries.insert(point{id, n}, o, addr, false);
+                    break;
+                }
+            }
+            n++;
+        }
+        return *this;
+    }
+    
+    template <
+        typename key,
+        typename tag,
+        typename script,
+        typename out, 
+        typename point, 
+        typename tx>
+    funds<key, tag, script, out, point, tx>& 
+    funds<key, tag, script, out, point, tx>::confirm(const cached& t) {
+        const auto& id = t.id();
+        for (index i = 0; i < data::size(t.transaction().outputs()); i++) Entries.confirm(point{id, i});
+        return *this;
+    }
+    
     template <
         typename key,
         typename tag,
@@ -17,44 +58,63 @@ namespace abstractions {
         typename point, 
         typename tx>
     typename wallet<key, tag, script, out, point, tx>::spent
-    wallet<key, tag, script, out, point, tx>::spend(list<data::map::entry<tag, satoshi>> to, satoshi fee) const {
-        satoshi spent = fee + 
+    wallet<key, tag, script, out, point, tx>::spend(list<data::map::entry<tag, satoshi>> to, const select::options& fees) const {
+        satoshi spent = 
             data::reduce(
                 [](satoshi p, data::map::entry<tag, satoshi> e)->satoshi{
                     return p + e.Value;
                 }, to);
-        if (spent > Funds.Balance) return {};
+        if (spent > Funds.balance()) return {};
         
-        satoshi change = Funds.Balance - spent; 
-        key next = data::first(Source);
+        auto pay = [this](data::map::entry<tag, satoshi> e)->out{
+            for (payable p : Pay) {
+                script pay_to = p.pay(e.Key);
+                if (pay_to != script{}) return {e.Value, pay_to};
+            }
+            return {};
+        };
         
-        list<out> outputs{
-            data::for_each(
-                [&](data::map::entry<tag, satoshi> e)->out{
-                    for (payable p : Pay) {
-                        script pay_to = p.pay(e.Key);
-                        if (pay_to != script{}) return {e.Value, pay_to};
-                    }
-                    return {};
-                }, 
-                data::append(to, data::map::entry<tag, satoshi>{Pay[Change].tag(next), change}))};
+        list<out> outputs{data::for_each(pay, to)};
+        
+        // the fee is for the outputs as well as the inputs, 
+        // so they count toward the size of the transaction. 
+        select::options o = fees;
+        for (const out& x : outputs) o.BaseSize += serialize::output_size(x);
+        
+        // the outputs are kept in order of value, so they need not be sorted.
+        using entry = typename utxo<point, out, tag>::entry;
+        std::vector<const entry*> entries{};
+        std::vector<satoshi> values{};
+        entries.reserve(Funds.Entries.size());
+        values.reserve(Funds.Entries.size());
+        Funds.Entries.for_each_by_value([&entries, &values](const entry& x) {
+            entries.push_back(&x);
+            values.push_back(x.Output.Value);
+        });
+        select::selection selected = select::coins(values, spent, o);
+        if (!selected.valid()) return {};
+        
+        // whatever is not change goes to the miner as selected.Fee.
+        key next = data::first(Source);
+        if (selected.Change != 0) 
+            outputs = data::append(outputs, pay(data::map::entry<tag, satoshi>{Pay[Change].tag(next), selected.Change}));
         
         using vertex = vertex<key, out, point>;
         using vertex_spendable = typename vertex::spendable;
         
-        list<vertex_spendable> inputs{
-            data::for_each(
-                [&](debit<out, point> x)->vertex_spendable{
-                    for(recognizable r : Funds.Recognize) {
-                        tag addr = r.tag(x.Output.ScriptPubKey);
-                        if (addr != tag{}) return {Funds.Keys[addr], x.Output, x.Point};
-                    } 
-                    return {};
-                }, 
-                Funds.Entries)};
-        
-        tx t = redeem(Funds.Recognize, vertex{inputs, outputs});
-        return {t, {funds{Funds.Recognize}.import(next).update(t), Pay, Change, data::rest(Source)}};
+        list<vertex_spendable> inputs{};
+        for (N i : selected.Inputs) inputs = inputs.prepend(
+            [&](const auto& x)->vertex_spendable{
+                for(recognizable r : Funds.Recognize) {
+                    tag addr = r.tag(x.Output.ScriptPubKey);
+                    if (addr != tag{}) return {Funds.Keys[addr], x.Output, x.Point};
+                } 
+                return {};
+            }(*entries[i]));
+        
+        typename funds::cached t{redeem(Funds.Recognize, vertex{inputs, outputs})};
+        // the new funds share everything they have in common with the old. 
+        return {t, {funds{Funds}.import(next).update(t), Pay, Change, data::rest(Source)}};
     };
     
 }
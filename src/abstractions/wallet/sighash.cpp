@@ -0,0 +1,148 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/wallet/sighash.hpp>
+
+namespace abstractions::bitcoin::sighash {
+    
+    namespace {
+        
+        const N outpoint_size = 36;
+        
+        // reads through a serialized transaction. 
+        struct cursor {
+            const byte* Begin;
+            const byte* At;
+            const byte* End;
+            
+            cursor(bytes& b) : Begin{b.data()}, At{b.data()}, End{b.data() + b.size()} {}
+            
+            N position() const {
+                return At - Begin;
+            }
+            
+            bool skip(N n) {
+                if (N(End - At) < n) return false;
+                At += n;
+                return true;
+            }
+            
+            bool var_int(N& n) {
+                if (At == End) return false;
+                byte b = *At++;
+                N size = b == 0xfd ? 2 : b == 0xfe ? 4 : b == 0xff ? 8 : 0;
+                if (size == 0) {
+                    n = b;
+                    return true;
+                }
+                if (N(End - At) < size) return false;
+                n = 0;
+                for (N i = 0; i < size; i++) n += N(*At++) << (8 * i);
+                return true;
+            }
+            
+            // skip something that is preceded by its size. 
+            bool skip_var() {
+                N n;
+                return var_int(n) && skip(n);
+            }
+        };
+        
+        void write_var_int(std::vector<byte>& b, N n) {
+            if (n < 0xfd) b.push_back(byte(n));
+            else if (n <= 0xffff) {
+                b.push_back(0xfd);
+                for (int i = 0; i < 2; i++) b.push_back(byte(n >> (8 * i)));
+            } else if (n <= 0xffffffff) {
+                b.push_back(0xfe);
+                for (int i = 0; i < 4; i++) b.push_back(byte(n >> (8 * i)));
+            } else {
+                b.push_back(0xff);
+                for (int i = 0; i < 8; i++) b.push_back(byte(n >> (8 * i)));
+            }
+        }
+        
+        template <typename it>
+        void append(std::vector<byte>& b, it begin, N size) {
+            b.insert(b.end(), begin, begin + size);
+        }
+        
+    }
+    
+    context::context(bytes& t) : Transaction{t}, Valid{false}, HashPrevouts{}, HashSequence{}, HashOutputs{}, Inputs{}, Outputs{}, Locktime{0} {
+        cursor c{Transaction};
+        N inputs, outputs;
+        if (!c.skip(4) || !c.var_int(inputs)) return;
+        
+        Inputs.reserve(inputs);
+        for (N i = 0; i < inputs; i++) {
+            N outpoint = c.position();
+            if (!c.skip(outpoint_size) || !c.skip_var()) return;
+            Inputs.push_back(input{outpoint, c.position()});
+            if (!c.skip(4)) return;
+        }
+        
+        if (!c.var_int(outputs)) return;
+        N begin = c.position();
+        Outputs.reserve(outputs);
+        for (N i = 0; i < outputs; i++) {
+            N offset = c.position();
+            if (!c.skip(8) || !c.skip_var()) return;
+            Outputs.push_back(output{offset, c.position() - offset});
+        }
+        N end = c.position();
+        
+        Locktime = c.position();
+        if (!c.skip(4) || c.At != c.End) return;
+        
+        std::vector<byte> prevouts{};
+        std::vector<byte> sequences{};
+        prevouts.reserve(Inputs.size() * outpoint_size);
+        sequences.reserve(Inputs.size() * 4);
+        for (const input& i : Inputs) {
+            append(prevouts, Transaction.begin() + i.Outpoint, outpoint_size);
+            append(sequences, Transaction.begin() + i.Sequence, 4);
+        }
+        
+        HashPrevouts = sha256::double_hash(prevouts);
+        HashSequence = sha256::double_hash(sequences);
+        HashOutputs = sha256::double_hash(std::vector<byte>(Transaction.begin() + begin, Transaction.begin() + end));
+        Valid = true;
+    }
+    
+    sha256::digest context::hash(N i, bytes& script_code, satoshi amount, uint32 d) const {
+        if (!Valid || i >= Inputs.size()) return {};
+        
+        uint32 base = d & 0x1f;
+        bool anyone_can_pay = d & sighash::anyone_can_pay;
+        const sha256::digest zero{};
+        
+        const sha256::digest* outputs = &zero;
+        sha256::digest single{};
+        if (base != sighash::single && base != sighash::none) outputs = &HashOutputs;
+        else if (base == sighash::single && i < Outputs.size()) {
+            single = sha256::double_hash(std::vector<byte>(
+                Transaction.begin() + Outputs[i].Offset, 
+                Transaction.begin() + Outputs[i].Offset + Outputs[i].Size));
+            outputs = &single;
+        }
+        
+        std::vector<byte> preimage{};
+        preimage.reserve(4 + 32 + 32 + outpoint_size + 9 + script_code.size() + 8 + 4 + 32 + 4 + 4);
+        
+        append(preimage, Transaction.begin(), 4);
+        append(preimage, (anyone_can_pay ? zero : HashPrevouts).begin(), 32);
+        append(preimage, (anyone_can_pay || base == sighash::single || base == sighash::none ? zero : HashSequence).begin(), 32);
+        append(preimage, Transaction.begin() + Inputs[i].Outpoint, outpoint_size);
+        write_var_int(preimage, script_code.size());
+        append(preimage, script_code.begin(), script_code.size());
+        for (int j = 0; j < 8; j++) preimage.push_back(byte(uint64(amount) >> (8 * j)));
+        append(preimage, Transaction.begin() + Inputs[i].Sequence, 4);
+        append(preimage, outputs->begin(), 32);
+        append(preimage, Transaction.begin() + Locktime, 4);
+        for (int j = 0; j < 4; j++) preimage.push_back(byte(d >> (8 * j)));
+        
+        return sha256::double_hash(preimage);
+    }
+    
+}
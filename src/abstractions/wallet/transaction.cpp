@@ -0,0 +1,18 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/wallet/transaction.hpp>
+
+namespace abstractions {
+    
+    namespace bitcoin {
+        
+        signature sign(output o, const sighash::context& c, N i, secret k, uint32 d) {
+            signature x = k.sign(c.hash(i, o.ScriptPubKey, o.Value, d));
+            x.push_back(byte(d));
+            return x;
+        }
+        
+    }
+    
+}
@@ -0,0 +1,271 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/work/jobs.hpp>
+
+#include <algorithm>
+
+namespace abstractions::work {
+    
+    // number of nonces a thread searches between checking 
+    // whether its job has been paused or has expired. 
+    const uint64 check_size = uint64(1) << 14;
+    
+    const uint64 last_nonce = uint64(0 - 1);
+    
+    bytes checkpoint::write() const {
+        std::vector<byte> b(size);
+        auto i = b.begin();
+        i = std::copy(Order.Reference.begin(), Order.Reference.end(), i);
+        i = std::copy(Order.Message.begin(), Order.Message.end(), i);
+        uint32 t = Order.Target;
+        for (int j = 0; j < 4; j++) *i++ = byte(t >> (8 * j));
+        for (int j = 0; j < 8; j++) *i++ = byte(Cursor >> (8 * j));
+        return b;
+    }
+    
+    checkpoint checkpoint::read(bytes& b) {
+        if (b.size() != size) return {};
+        checkpoint c{};
+        auto i = b.begin();
+        std::copy(i, i + 32, c.Order.Reference.begin());
+        i += 32;
+        std::copy(i, i + message_size, c.Order.Message.begin());
+        i += message_size;
+        uint32 t = 0;
+        for (int j = 0; j < 4; j++) t += uint32(*i++) << (8 * j);
+        c.Order.Target = target{t};
+        for (int j = 0; j < 8; j++) c.Cursor += uint64(*i++) << (8 * j);
+        return c;
+    }
+    
+    jobs::jobs(N threads, uint64 slice_size) : Jobs{}, Queue{}, Deadlines{}, 
+        SliceSize{slice_size == 0 ? 1 : slice_size}, Counter{0}, Stopping{false}, Threads{} {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        Threads.reserve(threads);
+        for (N i = 0; i < threads; i++) Threads.emplace_back(&jobs::run, this);
+    }
+    
+    // Slices that are being searched are interrupted. 
+    jobs::~jobs() {
+        {
+            std::lock_guard<std::mutex> l{Mutex};
+            Stopping = true;
+            for (auto& e : Jobs) e.second.Stop.store(true);
+        }
+        Work.notify_all();
+        for (std::thread& t : Threads) t.join();
+    }
+    
+    jobs::id jobs::add(checkpoint c, clock::time_point deadline) {
+        id i;
+        {
+            std::lock_guard<std::mutex> l{Mutex};
+            i = Counter++;
+            job& j = Jobs.emplace(std::piecewise_construct, std::forward_as_tuple(i), std::forward_as_tuple(i, c, deadline)).first->second;
+            // a checkpoint at the last nonce has nothing left to search. 
+            if (j.Status == pending && j.Next == last_nonce) j.Status = exhausted;
+            if (j.Status == pending) {
+                schedule(j);
+                if (deadline != clock::time_point::max()) Deadlines.emplace(deadline, i);
+            }
+        }
+        Work.notify_all();
+        return i;
+    }
+    
+    jobs::id jobs::resume(checkpoint c) {
+        return add(c, clock::time_point::max());
+    }
+    
+    jobs::id jobs::resume(checkpoint c, clock::duration timeout) {
+        return add(c, clock::now() + timeout);
+    }
+    
+    jobs::job* jobs::find(id i) {
+        auto e = Jobs.find(i);
+        return e == Jobs.end() || e->second.Forgotten ? nullptr : &e->second;
+    }
+    
+    const jobs::job* jobs::find(id i) const {
+        auto e = Jobs.find(i);
+        return e == Jobs.end() || e->second.Forgotten ? nullptr : &e->second;
+    }
+    
+    uint64 jobs::job::cursor() const {
+        uint64 c = Next;
+        if (!Slices.empty()) c = std::min(c, *Slices.begin());
+        if (!Unfinished.empty()) c = std::min(c, Unfinished.begin()->first);
+        return c;
+    }
+    
+    bool jobs::job::left() const {
+        return Next != last_nonce || !Unfinished.empty();
+    }
+    
+    jobs::status jobs::job::state(clock::time_point now) const {
+        if ((Status == pending || Status == paused) && Deadline <= now) return expired;
+        return Status;
+    }
+    
+    void jobs::schedule(job& j) {
+        if (j.Status == pending && j.left()) Queue.insert(j.priority());
+    }
+    
+    void jobs::finish(job& j, status s) {
+        j.Status = s;
+        j.Stop.store(true);
+        Queue.erase(j.priority());
+        Deadlines.erase({j.Deadline, j.Id});
+        Finished.notify_all();
+    }
+    
+    void jobs::pause(id i) {
+        std::lock_guard<std::mutex> l{Mutex};
+        job* j = find(i);
+        if (j == nullptr || j->Status != pending) return;
+        j->Status = paused;
+        // threads searching the job leave the rest of their slices. 
+        j->Stop.store(true);
+        Queue.erase(j->priority());
+    }
+    
+    void jobs::unpause(id i) {
+        {
+            std::lock_guard<std::mutex> l{Mutex};
+            job* j = find(i);
+            if (j == nullptr || j->Status != paused) return;
+            j->Status = pending;
+            j->Stop.store(false);
+            schedule(*j);
+        }
+        Work.notify_all();
+    }
+    
+    void jobs::cancel(id i) {
+        std::lock_guard<std::mutex> l{Mutex};
+        job* j = find(i);
+        if (j == nullptr) return;
+        if (j->Status == pending || j->Status == paused) finish(*j, cancelled);
+    }
+    
+    void jobs::forget(id i) {
+        std::lock_guard<std::mutex> l{Mutex};
+        job* j = find(i);
+        if (j == nullptr) return;
+        if (j->Status == pending || j->Status == paused) finish(*j, cancelled);
+        if (j->Slices.empty()) Jobs.erase(i);
+        else j->Forgotten = true;
+    }
+    
+    jobs::status jobs::state(id i) const {
+        std::lock_guard<std::mutex> l{Mutex};
+        const job* j = find(i);
+        return j == nullptr ? unknown : j->state(clock::now());
+    }
+    
+    candidate jobs::solution(id i) const {
+        std::lock_guard<std::mutex> l{Mutex};
+        const job* j = find(i);
+        if (j == nullptr) return {};
+        return j->Solution;
+    }
+    
+    jobs::status jobs::wait(id i) {
+        std::unique_lock<std::mutex> l{Mutex};
+        const job* j = find(i);
+        if (j == nullptr) return unknown;
+        clock::time_point deadline = j->Deadline;
+        
+        // look the job up each time since it may be forgotten meanwhile. 
+        status s = unknown;
+        auto done = [this, i, &s]()->bool{
+            const job* j = find(i);
+            s = j == nullptr ? unknown : j->state(clock::now());
+            return s != pending && s != paused;
+        };
+        
+        if (deadline == clock::time_point::max()) Finished.wait(l, done);
+        else Finished.wait_until(l, deadline, done);
+        return s;
+    }
+    
+    checkpoint jobs::save(id i) const {
+        std::lock_guard<std::mutex> l{Mutex};
+        const job* j = find(i);
+        if (j == nullptr) return {};
+        return checkpoint{j->Order, j->cursor()};
+    }
+    
+    std::vector<checkpoint> jobs::checkpoints() const {
+        std::vector<checkpoint> c{};
+        std::lock_guard<std::mutex> l{Mutex};
+        for (const auto& e : Jobs) {
+            const job& j = e.second;
+            if (!j.Forgotten && (j.Status == pending || j.Status == paused)) 
+                c.push_back(checkpoint{j.Order, j.cursor()});
+        }
+        return c;
+    }
+    
+    // Expire any jobs whose deadlines have passed and then take the 
+    // pending job with the easiest target. If there is nothing to do, 
+    // wait until there is or until the next deadline. 
+    jobs::job* jobs::next(std::unique_lock<std::mutex>& l) {
+        while (!Stopping) {
+            clock::time_point now = clock::now();
+            while (!Deadlines.empty() && Deadlines.begin()->first <= now) 
+                finish(Jobs.at(Deadlines.begin()->second), expired);
+            
+            if (!Queue.empty()) return &Jobs.at(Queue.begin()->second);
+            if (Deadlines.empty()) Work.wait(l);
+            else Work.wait_until(l, Deadlines.begin()->first);
+        }
+        return nullptr;
+    }
+    
+    void jobs::run() {
+        std::unique_lock<std::mutex> l{Mutex};
+        while (true) {
+            job* j = next(l);
+            if (j == nullptr) return;
+            
+            // finish interrupted slices before starting new ones. 
+            uint64 begin = j->Next;
+            uint64 end = last_nonce - begin > SliceSize ? begin + SliceSize : last_nonce;
+            if (!j->Unfinished.empty()) {
+                begin = j->Unfinished.begin()->first;
+                end = j->Unfinished.begin()->second;
+                j->Unfinished.erase(j->Unfinished.begin());
+            } else j->Next = end;
+            j->Slices.insert(begin);
+            if (!j->left()) Queue.erase(j->priority());
+            order o = j->Order;
+            clock::time_point deadline = j->Deadline;
+            
+            l.unlock();
+            uint64 cursor = begin;
+            candidate c{};
+            bool found = false;
+            while (!found && cursor != end && !j->Stop.load(std::memory_order_relaxed) && 
+                (deadline == clock::time_point::max() || clock::now() < deadline)) 
+                found = search(o, cursor, end - cursor > check_size ? cursor + check_size : end, j->Stop, c);
+            l.lock();
+            
+            j->Slices.erase(begin);
+            if (!found && cursor != end) j->Unfinished.emplace(cursor, end);
+            if (j->Forgotten) {
+                if (j->Slices.empty()) Jobs.erase(j->Id);
+                continue;
+            }
+            if (j->Status != pending && j->Status != paused) continue;
+            if (found) {
+                j->Solution = c;
+                finish(*j, solved);
+            } else if (!j->left() && j->Slices.empty()) finish(*j, exhausted);
+            else schedule(*j);
+        }
+    }
+    
+}
@@ -3,23 +3,136 @@
 
 #include <abstractions/work/work.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 namespace abstractions::work {
     
     work::order candidate::order() const {
         throw 0;
     }
     
+    candidate::candidate(uint32 version, struct order o, uint32 nonce) : uint640{} {
+        std::copy(o.Reference.begin(), o.Reference.end(), begin() + 4);
+        std::copy(o.Message.begin(), o.Message.end(), begin() + 36);
+        uint640::words_type::make(*this)[0] = version;
+        uint640::words_type::make(*this)[18] = o.Target;
+        uint640::words_type::make(*this)[19] = nonce;
+    }
+    
+    threshold::threshold(target t) : Words{}, Zeros{32}, Little{} {
+        // find out which end of a digest is the most significant. 
+        const sha256::digest one = uint256{1};
+        Little = static_cast<const std::array<byte, 32>&>(one)[0] == 1;
+        
+        // no digest is below zero. 
+        if (!t.valid()) return;
+        Zeros = 0;
+        
+        const sha256::digest expanded = t.expand();
+        const std::array<byte, 32>& b = static_cast<const std::array<byte, 32>&>(expanded);
+        for (int i = 0; i < 4; i++) Words[i] = word(b, i);
+        while (Zeros < 32 && b[Little ? 31 - Zeros : Zeros] == 0) Zeros++;
+    }
+    
+    N candidate::satisfied(const sha256::midstate& m, const threshold& t, N count) const {
+        const N lanes = sha256::lanes();
+        const N tail = 80 - m.Length;
+        const uint32 first = nonce();
+        
+        candidate c = *this;
+        std::array<byte, 80 * sha256::max_lanes> tails;
+        std::array<sha256::digest, sha256::max_lanes> digests;
+        
+        for (N i = 0; i < count; i += lanes) {
+            N n = std::min(lanes, count - i);
+            for (N j = 0; j < n; j++) {
+                c.nonce(first + uint32(i + j));
+                std::copy(c.begin() + m.Length, c.end(), tails.begin() + tail * j);
+            }
+            sha256::finish(m, tails.data(), tail, n, digests.data());
+            for (N j = 0; j < n; j++) if (t.below(digests[j])) return i + j;
+        }
+        
+        return count;
+    }
+    
     // roughly 1/16 odds. 
     const target minimum{32, 0x000fffff};
     
-    candidate work(order o) {
-        if (o.Target < minimum) return {};
-        uint64 nonce = 0;
-        while (true) {
-            candidate c{data::lesser(nonce), o, data::greater(nonce)};
-            if (c.satisfied()) return c;
-            nonce++;
+    // number of nonces a worker tries between checking 
+    // whether another worker has found a solution. 
+    const N batch_size = 1024;
+    
+    bool search(order o, uint64& cursor, uint64 end, const std::atomic<bool>& stop, candidate& solution) {
+        // The lesser half of the nonce goes in the nonce field and the 
+        // greater half in the version field, so that the midstate only 
+        // needs to be recomputed once every 2^32 hashes. Nonces are 
+        // tried in batches so that many can be hashed at once. 
+        const threshold t{o.Target};
+        while (cursor != end && !stop.load(std::memory_order_relaxed)) {
+            candidate c{data::greater(cursor), o, data::lesser(cursor)};
+            sha256::midstate m = c.prefix();
+            
+            // stop where the version field would change.
+            uint64 next = (cursor | 0xffffffff) + 1;
+            uint64 last = next == 0 || next > end ? end : next;
+            
+            while (cursor != last && !stop.load(std::memory_order_relaxed)) {
+                N batch = std::min(last - cursor, uint64(batch_size));
+                c.nonce(data::lesser(cursor));
+                N tried = c.satisfied(m, t, batch);
+                if (tried < batch) {
+                    c.nonce(data::lesser(cursor + tried));
+                    cursor += tried + 1;
+                    solution = c;
+                    return true;
+                }
+                cursor += batch;
+            }
         }
+        return false;
+    }
+    
+    report search(order o, N threads) {
+        if (o.Target < minimum) return {};
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        
+        // each thread gets its own contiguous range of nonces. 
+        const uint64 range = uint64(0 - 1) / threads;
+        
+        std::atomic<bool> found{false};
+        std::atomic<uint64> hashes{0};
+        std::mutex lock;
+        candidate solution{};
+        
+        auto worker = [&](uint64 begin, uint64 end) {
+            uint64 cursor = begin;
+            candidate c{};
+            bool success = search(o, cursor, end, found, c);
+            hashes.fetch_add(cursor - begin);
+            if (!success) return;
+            std::lock_guard<std::mutex> l{lock};
+            if (!found.load()) {
+                solution = c;
+                found.store(true);
+            }
+        };
+        
+        auto start = std::chrono::steady_clock::now();
+        
+        std::vector<std::thread> workers{};
+        workers.reserve(threads);
+        for (N i = 0; i < threads; i++) 
+            workers.emplace_back(worker, i * range, i + 1 == threads ? uint64(0 - 1) : (i + 1) * range);
+        for (std::thread& t : workers) t.join();
+        
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return {solution, hashes.load(), elapsed.count()};
     }
     
 }
@@ -0,0 +1,59 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#ifndef TEST_BENCH_BENCH
+#define TEST_BENCH_BENCH
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace abstractions::bench {
+    
+    using clock = std::chrono::steady_clock;
+    
+    // keep the compiler from optimizing away a result. 
+    template <typename X>
+    inline void keep(const X& x) {
+        asm volatile("" : : "g"(&x) : "memory");
+    }
+    
+    // call f repeatedly for at least the given number of seconds 
+    // and return the number of calls per second. 
+    template <typename f>
+    double rate(f fun, double seconds = 1.0) {
+        unsigned long long calls = 0;
+        clock::time_point start = clock::now();
+        std::chrono::duration<double> elapsed{0};
+        do {
+            for (int i = 0; i < 64; i++) fun();
+            calls += 64;
+            elapsed = clock::now() - start;
+        } while (elapsed.count() < seconds);
+        return calls / elapsed.count();
+    }
+    
+    inline void report(const std::string& name, double amount, const std::string& unit) {
+        std::cout << name << ": " << amount << " " << unit << std::endl;
+    }
+    
+    struct benchmark {
+        std::string Name;
+        std::function<void()> Run;
+        
+        static std::vector<benchmark>& all() {
+            static std::vector<benchmark> b{};
+            return b;
+        }
+        
+        // register a benchmark to be run by benchAbstractions. 
+        benchmark(std::string name, std::function<void()> run) : Name{name}, Run{run} {
+            all().push_back(*this);
+        }
+    };
+    
+}
+
+#endif
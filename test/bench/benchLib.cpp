@@ -0,0 +1,16 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include "bench.hpp"
+
+// Runs every benchmark whose name contains the first argument, 
+// or all of them if there is no argument. 
+int main(int argc, char *argv[]){
+    std::string filter = argc > 1 ? argv[1] : "";
+    for (const abstractions::bench::benchmark& b : abstractions::bench::benchmark::all()) {
+        if (b.Name.find(filter) == std::string::npos) continue;
+        std::cout << "== " << b.Name << std::endl;
+        b.Run();
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/view.hpp>
+
+#include "bench.hpp"
+
+namespace abstractions::bench {
+
+    // a block of transactions with two inputs and two outputs.
+    std::vector<byte> block(N transactions) {
+        std::vector<byte> tx(4, 1);
+        tx.push_back(2);
+        for (int i = 0; i < 2; i++) {
+            tx.insert(tx.end(), 36, byte(i));
+            tx.push_back(107);
+            tx.insert(tx.end(), 107, 0x51);
+            tx.insert(tx.end(), 4, 0xff);
+        }
+        tx.push_back(2);
+        for (int i = 0; i < 2; i++) {
+            tx.insert(tx.end(), 8, byte(i + 1));
+            tx.push_back(25);
+            tx.insert(tx.end(), 25, 0x76);
+        }
+        tx.insert(tx.end(), 4, 0);
+
+        std::vector<byte> b(80, 0);
+        b.push_back(0xfe);
+        for (int i = 0; i < 4; i++) b.push_back(byte(transactions >> (8 * i)));
+        for (N i = 0; i < transactions; i++) b.insert(b.end(), tx.begin(), tx.end());
+        return b;
+    }
+
+    // reads a field at a time, as the reader in transaction.cpp does.
+    struct fields : data::slice_reader {
+        using slice_reader::operator>>;
+        fields(std::vector<byte>& b) : slice_reader{b, boost::endian::order::little} {}
+
+        N var_int() {
+            byte b;
+            *this >> b;
+            if (b < 0xfd) return b;
+            if (b == 0xfd) {
+                uint16_t x;
+                *this >> x;
+                return x;
+            }
+            if (b == 0xfe) {
+                uint32_t x;
+                *this >> x;
+                return x;
+            }
+            uint64_t x;
+            *this >> x;
+            return x;
+        }
+
+        void skip(N n) {
+            byte b;
+            for (N i = 0; i < n; i++) *this >> b;
+        }
+
+        // returns the total value of the outputs.
+        satoshi block() {
+            satoshi total = 0;
+            uint32_t x;
+            skip(80);
+            N transactions = var_int();
+            for (N t = 0; t < transactions; t++) {
+                *this >> x;
+                N inputs = var_int();
+                for (N i = 0; i < inputs; i++) {
+                    skip(36);
+                    skip(var_int());
+                    *this >> x;
+                }
+                N outputs = var_int();
+                for (N i = 0; i < outputs; i++) {
+                    uint64_t value;
+                    *this >> value;
+                    total += value;
+                    skip(var_int());
+                }
+                *this >> x;
+            }
+            return total;
+        }
+    };
+
+    benchmark parse_block{"parse/block", []() {
+        std::vector<byte> b = block(10000);
+        double megabytes = b.size() / 1000000.0;
+
+        report("field at a time", megabytes * rate([&b]() {
+            keep(fields{b}.block());
+        }), "MB per second");
+
+        report("view::transaction", megabytes * rate([&b]() {
+            slice<byte> s = slice<byte>::make(b);
+            N at = 81 + 4;
+            satoshi total = 0;
+            for (N t = 0; t < 10000; t++) {
+                view::transaction tx{s.range(at, s.size())};
+                for (N o = 0; o < tx.outputs(); o++) total += tx.output(o).Value;
+                at += tx.size();
+            }
+            keep(total);
+        }), "MB per second");
+
+        report("view::block", megabytes * rate([&b]() {
+            view::block k{b};
+            satoshi total = 0;
+            for (N o = 0; o < k.outputs(); o++) total += k.value(o);
+            keep(total);
+        }), "MB per second");
+    }};
+
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/script/pay_to_address.hpp>
+#include <abstractions/script/pow.hpp>
+#include <abstractions/script/optimize.hpp>
+#include <abstractions/script/interpreter.hpp>
+
+#include "bench.hpp"
+
+namespace abstractions::bench {
+    
+    // measure building a script and then compiling a script 
+    // that has already been built into a reused buffer. 
+    template <typename build>
+    void scripts(build make) {
+        report("build and compile", rate([&make]() {
+            keep(make()->compile());
+        }), "scripts per second");
+        
+        pointer<script::program> p = make();
+        std::vector<byte> buffer(p->length());
+        report("compile into buffer", rate([&p, &buffer]() {
+            keep(p->compile(buffer.data()));
+        }), "scripts per second");
+    }
+    
+    benchmark pay_to_address{"script/pay_to", []() {
+        bitcoin::address a{ripemd160::digest{}};
+        scripts([&a]() {
+            return script::pay_to(a);
+        });
+        
+        report("flat build and compile", rate([&a]() {
+            script::flat f{};
+            f.reserve(5, 20);
+            keep(script::pay_to(f, a).compile());
+        }), "scripts per second");
+    }};
+    
+    benchmark pow_lock{"script/pow_lock", []() {
+        sha256::digest d{};
+        scripts([&d]() {
+            return script::lock_by_pow(d, work::target{0x1d00ffff});
+        });
+        
+        pointer<script::program> p = script::lock_by_pow(d, work::target{0x1d00ffff});
+        report("optimize", rate([&p]() {
+            keep(script::optimize(*p));
+        }), "scripts per second");
+        report("bytes saved by optimize", script::optimize(*p).saved(), "bytes");
+    }};
+    
+    // without a checker every signature fails, so this measures 
+    // everything in running a pay to address script but the ecdsa. 
+    benchmark interpret{"script/interpreter", []() {
+        bitcoin::address a{ripemd160::digest{}};
+        const std::vector<byte> output = script::pay_to(a)->compile();
+        const std::vector<byte> input = script::sequence({
+            script::push_data(std::vector<byte>(71, 1)), 
+            script::push_data(std::vector<byte>(33, 2))})->compile();
+        script::interpreter machine{};
+        report("run pay to address", rate([&]() {
+            keep(machine.run(output, input));
+        }), "scripts per second");
+    }};
+    
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <random>
+
+#include <abstractions/select.hpp>
+
+#include "bench.hpp"
+
+namespace abstractions::bench {
+
+    // outputs of random value between 1000 and 10000000 satoshis.
+    std::vector<satoshi> outputs(N size) {
+        std::mt19937_64 r{size};
+        std::vector<satoshi> v(size);
+        for (satoshi& x : v) x = 1000 + r() % 10000000;
+        return v;
+    }
+
+    template <typename f>
+    void selections(const std::string& name, f select) {
+        for (N size : {10000, 100000, 1000000}) {
+            std::vector<satoshi> v = outputs(size);
+            select::selection s{};
+            // one selection over a large set takes too long for rate().
+            N calls = 0;
+            clock::time_point start = clock::now();
+            std::chrono::duration<double> elapsed{0};
+            do {
+                s = select(v, satoshi(123456789));
+                calls++;
+                elapsed = clock::now() - start;
+            } while (elapsed.count() < 0.5);
+            report(name + " over " + std::to_string(size), calls / elapsed.count(), "selections per second");
+            report("  inputs", s.Inputs.size(), "");
+            report("  waste", s.Waste, "satoshis");
+        }
+    }
+
+    benchmark coin_selection{"select", []() {
+        selections("branch and bound", [](const std::vector<satoshi>& v, satoshi x) {
+            return select::branch_and_bound(v, x);
+        });
+        selections("largest first", [](const std::vector<satoshi>& v, satoshi x) {
+            return select::largest_first(v, x);
+        });
+        selections("knapsack", [](const std::vector<satoshi>& v, satoshi x) {
+            return select::knapsack(v, x);
+        });
+        selections("coins", [](const std::vector<satoshi>& v, satoshi x) {
+            return select::coins(v, x);
+        });
+    }};
+
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <thread>
+
+#include <abstractions/work/work.hpp>
+
+#include "bench.hpp"
+
+namespace abstractions::bench {
+    
+    // a target which is never satisfied, so that 
+    // searches run for as long as we let them. 
+    const work::target impossible{3, 0x00000001};
+    
+    work::order order(work::target t) {
+        return work::order{sha256::digest{}, work::message{}, t};
+    }
+    
+    benchmark candidate_satisfied{"work/candidate::satisfied", []() {
+        work::candidate c{0, order(impossible), 0};
+        const work::threshold t{impossible};
+        report("hashes", rate([&c, &t]() {
+            c.nonce(c.nonce() + 1);
+            keep(c.satisfied(t));
+        }), "per second");
+        
+        sha256::midstate m = c.prefix();
+        report("hashes with midstate", rate([&c, &m, &t]() {
+            c.nonce(c.nonce() + 1);
+            keep(c.satisfied(m, t));
+        }), "per second");
+        
+        const N batch = 1024;
+        report("hashes with midstate in batches", batch * rate([&c, &m, &t]() {
+            c.nonce(c.nonce() + batch);
+            keep(c.satisfied(m, t, batch));
+        }), "per second");
+    }};
+    
+    benchmark target_expand{"work/target::expand", []() {
+        work::target t{0x1d00ffff};
+        report("expansions", rate([&t]() {
+            keep(t.expand());
+        }), "per second");
+        
+        report("thresholds", rate([&t]() {
+            keep(work::threshold{t});
+        }), "per second");
+        
+        work::threshold h{t};
+        sha256::digest d = sha256::midstate{}.finish(nullptr, 0);
+        report("threshold comparisons", rate([&h, &d]() {
+            keep(h.below(d));
+        }), "per second");
+    }};
+    
+    benchmark end_to_end{"work/work", []() {
+        // only targets at least as easy as work::minimum are searched. 
+        for (uint32 t : {0x20ffffff, 0x207fffff, 0x201fffff, 0x200fffff}) {
+            N solved = 0;
+            clock::time_point start = clock::now();
+            std::chrono::duration<double> elapsed{0};
+            do {
+                keep(work::search(order(work::target{t}), 0));
+                solved++;
+                elapsed = clock::now() - start;
+            } while (elapsed.count() < 1.0);
+            report("target " + std::to_string(t) + " solutions", solved / elapsed.count(), "per second");
+        }
+    }};
+    
+    benchmark thread_scaling{"work/threads", []() {
+        const uint64 per_thread = uint64(1) << 22;
+        N cores = std::thread::hardware_concurrency();
+        if (cores == 0) cores = 1;
+        for (N threads = 1; threads <= cores; threads *= 2) {
+            std::atomic<bool> stop{false};
+            std::vector<std::thread> workers{};
+            clock::time_point start = clock::now();
+            for (N i = 0; i < threads; i++) workers.emplace_back([&stop, i, per_thread]() {
+                uint64 cursor = i * per_thread;
+                work::candidate solution{};
+                work::search(order(impossible), cursor, cursor + per_thread, stop, solution);
+            });
+            for (std::thread& w : workers) w.join();
+            std::chrono::duration<double> elapsed = clock::now() - start;
+            report(std::to_string(threads) + " threads", threads * per_thread / elapsed.count(), "hashes per second");
+        }
+    }};
+    
+}
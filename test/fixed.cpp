@@ -0,0 +1,65 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <random>
+
+#include <abstractions/script/pay_to_address.hpp>
+#include <abstractions/script/pay_to_pubkey.hpp>
+#include <abstractions/script/pow.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::script {
+
+    namespace {
+
+        template <typename X>
+        X random(std::mt19937& r) {
+            X x{};
+            for (byte& b : x) b = byte(r());
+            return x;
+        }
+
+        work::target random_target(std::mt19937& r) {
+            return work::target{byte(3 + r() % 30), uint32(1 + r() % 0x00ffffff)};
+        }
+
+    }
+
+    // every template writes the same script as the program it stands for.
+    TEST(FixedTest, TestPayToAddress) {
+        std::mt19937 r{9};
+        for (int n = 0; n < 100; n++) {
+            bitcoin::address a{random<ripemd160::digest>(r)};
+            bytes expected = pay_to(a)->compile();
+            EXPECT_EQ(templates::pay_to(a), expected);
+            EXPECT_EQ(pay_to_address{a}.Script, expected);
+        }
+    }
+
+    TEST(FixedTest, TestPayToPubkey) {
+        std::mt19937 r{10};
+        for (int n = 0; n < 100; n++) {
+            secp256k1::compressed_pubkey c = random<secp256k1::compressed_pubkey>(r);
+            EXPECT_EQ(templates::pay_to(c), pay_to(c)->compile());
+
+            secp256k1::uncompressed_pubkey u = random<secp256k1::uncompressed_pubkey>(r);
+            EXPECT_EQ(templates::pay_to(u), pay_to(u)->compile());
+        }
+    }
+
+    TEST(FixedTest, TestLockByPow) {
+        std::mt19937 r{11};
+        std::vector<work::target> targets{work::easy, work::hard, work::target{0x1d00ffff}};
+        for (int n = 0; n < 100; n++) targets.push_back(random_target(r));
+
+        for (work::target t : targets) {
+            sha256::digest m = random<sha256::digest>(r);
+            EXPECT_EQ(templates::lock_by_pow(m, t), lock_by_pow(m, t)->compile()) << uint32(t);
+        }
+
+        // the zero bytes are the same with any message.
+        EXPECT_EQ(templates::lock_by_pow(sha256::digest{}, work::easy), lock_by_pow(sha256::digest{}, work::easy)->compile());
+    }
+
+}
@@ -0,0 +1,246 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <array>
+#include <functional>
+#include <map>
+#include <random>
+
+#include <abstractions/utxo.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions {
+
+    namespace {
+
+        struct identity {
+            N operator()(N x) const {
+                return x;
+            }
+        };
+
+        // every key collides with every key that has the same remainder.
+        struct collide {
+            N operator()(N x) const {
+                return x % 3;
+            }
+        };
+
+        // keys which hash the same except in the highest bits.
+        struct high {
+            N operator()(N x) const {
+                return x << 60;
+            }
+        };
+
+        template <typename hash>
+        using trie = hamt<N, N, hash, std::equal_to<N>>;
+
+        // compare a trie with a map that holds what it ought to.
+        template <typename hash>
+        void check(const trie<hash>& t, const std::map<N, N>& m) {
+            EXPECT_EQ(t.size(), m.size());
+            EXPECT_EQ(t.empty(), m.empty());
+            for (const auto& e : m) {
+                const N* v = t.find(e.first);
+                ASSERT_NE(v, nullptr) << "key " << e.first;
+                EXPECT_EQ(*v, e.second);
+            }
+            N count = 0;
+            t.for_each([&m, &count](N k, N v) {
+                auto e = m.find(k);
+                ASSERT_NE(e, m.end()) << "key " << k;
+                EXPECT_EQ(v, e->second);
+                count++;
+            });
+            EXPECT_EQ(count, m.size());
+        }
+
+        // insert and remove at random and keep every version along the way.
+        template <typename hash>
+        void random(N keys, N steps, uint32 seed) {
+            std::mt19937 r{seed};
+            std::vector<trie<hash>> tries{trie<hash>{}};
+            std::vector<std::map<N, N>> maps{std::map<N, N>{}};
+            for (N n = 0; n < steps; n++) {
+                N k = r() % keys;
+                trie<hash> t = tries.back();
+                std::map<N, N> m = maps.back();
+                if (r() % 3 == 0) {
+                    t = t.remove(k);
+                    m.erase(k);
+                    EXPECT_FALSE(t.contains(k));
+                } else {
+                    N v = r();
+                    t = t.insert(k, v);
+                    m[k] = v;
+                }
+                tries.push_back(t);
+                maps.push_back(m);
+            }
+            for (N i = 0; i < tries.size(); i++) check(tries[i], maps[i]);
+        }
+
+        using digest = std::array<byte, 32>;
+        using address = std::array<byte, 20>;
+
+        struct point {
+            digest Reference;
+            uint32 Index;
+        };
+
+        struct output {
+            satoshi Value;
+        };
+
+        digest tx(byte x) {
+            digest d{};
+            d.fill(x);
+            return d;
+        }
+
+        address tag(byte x) {
+            address a{};
+            a.fill(x);
+            return a;
+        }
+
+        using outputs = utxo<point, output, address>;
+
+        satoshi sum(const outputs& u, const address& t) {
+            satoshi x = 0;
+            u.for_each(t, [&x](const outputs::entry& e) {
+                x += e.Output.Value;
+            });
+            return x;
+        }
+
+    }
+
+    TEST(HAMTTest, TestEmpty) {
+        trie<identity> t{};
+        EXPECT_TRUE(t.empty());
+        EXPECT_EQ(t.find(0), nullptr);
+        EXPECT_TRUE(t.remove(0).empty());
+    }
+
+    TEST(HAMTTest, TestInsertRemove) {
+        random<identity>(100, 2000, 1);
+        random<identity>(100000, 2000, 2);
+    }
+
+    TEST(HAMTTest, TestCollisions) {
+        random<collide>(20, 500, 3);
+        random<high>(16, 500, 4);
+    }
+
+    TEST(HAMTTest, TestReplace) {
+        trie<identity> a = trie<identity>{}.insert(1, 10);
+        trie<identity> b = a.insert(1, 20);
+        EXPECT_EQ(b.size(), 1);
+        EXPECT_EQ(*a.find(1), 10);
+        EXPECT_EQ(*b.find(1), 20);
+    }
+
+    TEST(HAMTTest, TestSnapshot) {
+        trie<identity> a{};
+        for (N i = 0; i < 1000; i++) a = a.insert(i, i);
+        trie<identity> b = a;
+        for (N i = 0; i < 1000; i += 2) b = b.remove(i);
+        for (N i = 1000; i < 1100; i++) b = b.insert(i, i);
+
+        EXPECT_EQ(a.size(), 1000);
+        EXPECT_EQ(b.size(), 600);
+        for (N i = 0; i < 1000; i++) EXPECT_EQ(*a.find(i), i);
+        EXPECT_FALSE(a.contains(1050));
+        EXPECT_FALSE(b.contains(500));
+        EXPECT_TRUE(b.contains(501));
+    }
+
+    TEST(UTXOTest, TestTotals) {
+        outputs u{};
+        EXPECT_TRUE(u.insert(point{tx(1), 0}, output{100}, tag(1)));
+        EXPECT_TRUE(u.insert(point{tx(1), 1}, output{200}, tag(2), false));
+        EXPECT_TRUE(u.insert(point{tx(2), 0}, output{400}, tag(1), false));
+        EXPECT_FALSE(u.insert(point{tx(1), 0}, output{800}, tag(1)));
+
+        EXPECT_EQ(u.size(), 3);
+        EXPECT_EQ(u.value(), 700);
+        EXPECT_EQ(u.confirmed(), 100);
+        EXPECT_EQ(u.unconfirmed(), 600);
+        EXPECT_EQ(u.value(tag(1)), 500);
+        EXPECT_EQ(u.value(tag(2)), 200);
+        EXPECT_EQ(u.value(tag(3)), 0);
+        EXPECT_EQ(sum(u, tag(1)), 500);
+
+        EXPECT_TRUE(u.confirm(point{tx(2), 0}));
+        EXPECT_FALSE(u.confirm(point{tx(2), 0}));
+        EXPECT_FALSE(u.confirm(point{tx(3), 0}));
+        EXPECT_EQ(u.confirmed(), 500);
+
+        EXPECT_TRUE(u.remove(point{tx(1), 0}));
+        EXPECT_FALSE(u.remove(point{tx(1), 0}));
+        EXPECT_EQ(u.value(), 600);
+        EXPECT_EQ(u.confirmed(), 400);
+        EXPECT_EQ(u.value(tag(1)), 400);
+        EXPECT_EQ(sum(u, tag(1)), 400);
+
+        EXPECT_TRUE(u.remove(point{tx(1), 1}));
+        EXPECT_EQ(u.value(tag(2)), 0);
+        EXPECT_EQ(sum(u, tag(2)), 0);
+        EXPECT_EQ(u.find(point{tx(1), 1}), nullptr);
+        EXPECT_EQ(u.find(point{tx(2), 0})->Output.Value, 400);
+    }
+
+    TEST(UTXOTest, TestSnapshot) {
+        outputs a{};
+        for (uint32 i = 0; i < 100; i++) a.insert(point{tx(byte(i)), i}, output{i + 1}, tag(byte(i % 4)), i % 2 == 0);
+        outputs b = a;
+        for (uint32 i = 0; i < 100; i += 3) b.remove(point{tx(byte(i)), i});
+        for (uint32 i = 1; i < 100; i += 2) b.confirm(point{tx(byte(i)), i});
+
+        // a is just as it was.
+        EXPECT_EQ(a.size(), 100);
+        EXPECT_EQ(a.value(), 5050);
+        EXPECT_EQ(a.confirmed(), 2500);
+        for (byte t = 0; t < 4; t++) EXPECT_EQ(a.value(tag(t)), sum(a, tag(t)));
+
+        satoshi value = 0;
+        b.for_each([&value](const outputs::entry& e) {
+            EXPECT_TRUE(e.Confirmed);
+            value += e.Output.Value;
+        });
+        EXPECT_EQ(b.size(), 66);
+        EXPECT_EQ(b.value(), value);
+        EXPECT_EQ(b.confirmed(), value);
+        for (byte t = 0; t < 4; t++) EXPECT_EQ(b.value(tag(t)), sum(b, tag(t)));
+    }
+
+    TEST(UTXOTest, TestByValue) {
+        std::mt19937 r{7};
+        outputs a{};
+        std::vector<point> points{};
+        for (uint32 i = 0; i < 200; i++) {
+            points.push_back(point{tx(byte(r())), i});
+            a.insert(points.back(), output{satoshi(r() % 50)}, tag(byte(i % 4)));
+        }
+
+        // many outputs have the same value, and those which remain stay in order.
+        outputs b = a;
+        for (N i = 0; i < points.size(); i += 3) b.remove(points[i]);
+
+        for (const outputs& u : {a, b}) {
+            std::vector<satoshi> values{};
+            satoshi total = 0;
+            u.for_each_by_value([&values, &total](const outputs::entry& e) {
+                values.push_back(e.Output.Value);
+                total += e.Output.Value;
+            });
+            EXPECT_EQ(values.size(), u.size());
+            EXPECT_EQ(total, u.value());
+            EXPECT_TRUE(std::is_sorted(values.begin(), values.end(), std::greater<satoshi>{}));
+        }
+    }
+
+}
@@ -0,0 +1,200 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <random>
+
+#include <abstractions/script/flat.hpp>
+#include <abstractions/script/interpreter.hpp>
+
+#include <gtest/gtest.h>
+
+// Every script here has been worked out by hand against
+// the rules that Satoshi's interpreter follows.
+namespace abstractions::script {
+
+    namespace {
+
+        using op = program::op;
+
+        bool native(bytes& output, bytes& input) {
+            return interpreter{}.run(output, input);
+        }
+
+        std::vector<byte> push(bytes& b) {
+            flat f{};
+            f.push(b);
+            return f.compile();
+        }
+
+        std::vector<byte> join(std::vector<std::vector<byte>> parts) {
+            std::vector<byte> b{};
+            for (const std::vector<byte>& p : parts) b.insert(b.end(), p.begin(), p.end());
+            return b;
+        }
+
+        struct test {
+            std::vector<byte> Output;
+            std::vector<byte> Input;
+            bool Expected;
+        };
+
+        const std::vector<test> scripts{
+            {{program::OP_1}, {}, true},
+            {{program::OP_0}, {}, false},
+            {{}, {program::OP_1}, true},
+            {{}, {}, false},
+            {{program::OP_ADD, program::OP_5, program::OP_EQUAL}, {program::OP_2, program::OP_3}, true},
+            {{program::OP_SUB, program::OP_1, program::OP_EQUAL}, {program::OP_2, program::OP_3}, false},
+            {{program::OP_SUB, program::OP_1NEGATE, program::OP_EQUAL}, {program::OP_2, program::OP_3}, true},
+            {{program::OP_1ADD, program::OP_0, program::OP_NUMEQUAL}, {program::OP_1NEGATE}, true},
+            {{program::OP_WITHIN}, {program::OP_2, program::OP_1, program::OP_3}, true},
+            {{program::OP_WITHIN}, {program::OP_3, program::OP_1, program::OP_3}, false},
+            {{program::OP_IF, program::OP_1, program::OP_ELSE, program::OP_0, program::OP_ENDIF}, {program::OP_1}, true},
+            {{program::OP_IF, program::OP_1, program::OP_ELSE, program::OP_0, program::OP_ENDIF}, {program::OP_0}, false},
+            {{program::OP_NOTIF, program::OP_1, program::OP_ENDIF}, {program::OP_0}, true},
+            {{program::OP_IF, program::OP_1}, {program::OP_1}, false},
+            {{program::OP_ENDIF, program::OP_1}, {}, false},
+            {{program::OP_RETURN}, {program::OP_1}, false},
+            {{program::OP_VERIFY, program::OP_1}, {program::OP_0}, false},
+            {{program::OP_VERIFY, program::OP_1}, {program::OP_2}, true},
+            {{program::OP_DUP}, {}, false},
+            {{program::OP_EQUAL}, {program::OP_1, program::OP_DUP}, true},
+            {{program::OP_DEPTH, program::OP_2, program::OP_NUMEQUAL}, {program::OP_1, program::OP_1}, true},
+            {{program::OP_ROT, program::OP_1, program::OP_EQUALVERIFY, program::OP_3, program::OP_EQUALVERIFY, program::OP_2, program::OP_EQUAL},
+                {program::OP_1, program::OP_2, program::OP_3}, true},
+            {{program::OP_TOALTSTACK, program::OP_DEPTH, program::OP_0, program::OP_EQUALVERIFY, program::OP_FROMALTSTACK}, {program::OP_1}, true},
+            {{program::OP_CAT, 0x02, 0xaa, 0xbb, program::OP_EQUAL}, {0x01, 0xaa, 0x01, 0xbb}, true},
+            {{program::OP_SPLIT, 0x01, 0xbb, program::OP_EQUALVERIFY, 0x01, 0xaa, program::OP_EQUAL}, {0x02, 0xaa, 0xbb, program::OP_1}, true},
+            {{program::OP_SPLIT}, {0x02, 0xaa, 0xbb, program::OP_3}, false},
+            {{program::OP_SIZE, program::OP_2, program::OP_EQUALVERIFY}, {0x02, 0xaa, 0xbb}, true},
+            {{program::OP_ADD}, {0x05, 1, 2, 3, 4, 5, program::OP_1}, false},
+            {{program::OP_ADD}, {0x04, 1, 2, 3, 4, program::OP_1}, true},
+            {{program::OP_DUP, program::OP_HASH160, 0x01, 0x00, program::OP_EQUALVERIFY, program::OP_CHECKSIG}, {0x01, 0x00, 0x01, 0x00}, false},
+            {join({{program::OP_SHA256}, push(std::vector<byte>{
+                0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+                0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55}), {program::OP_EQUAL}}),
+                {program::OP_0}, true},
+            {{program::OP_DROP, program::OP_1}, push(std::vector<byte>(520, 1)), true},
+            {{program::OP_DROP, program::OP_1}, push(std::vector<byte>(521, 1)), false}};
+
+        // op codes that need nothing but the stack.
+        const std::vector<op> alphabet{
+            program::OP_0, program::OP_1NEGATE, program::OP_1, program::OP_2, program::OP_3, program::OP_16,
+            program::OP_IF, program::OP_NOTIF, program::OP_ELSE, program::OP_ENDIF, program::OP_VERIFY,
+            program::OP_TOALTSTACK, program::OP_FROMALTSTACK, program::OP_IFDUP, program::OP_DEPTH,
+            program::OP_DROP, program::OP_DUP, program::OP_NIP, program::OP_OVER, program::OP_PICK,
+            program::OP_ROLL, program::OP_ROT, program::OP_SWAP, program::OP_TUCK, program::OP_2DUP,
+            program::OP_3DUP, program::OP_CAT, program::OP_SPLIT, program::OP_SIZE, program::OP_EQUAL,
+            program::OP_1ADD, program::OP_1SUB, program::OP_NEGATE, program::OP_ABS, program::OP_NOT,
+            program::OP_0NOTEQUAL, program::OP_ADD, program::OP_SUB, program::OP_BOOLAND, program::OP_BOOLOR,
+            program::OP_NUMEQUAL, program::OP_LESSTHAN, program::OP_MIN, program::OP_MAX, program::OP_WITHIN};
+
+        // remembers the script code that a signature is checked against.
+        struct recorder : interpreter::checker {
+            mutable std::vector<byte> ScriptCode;
+
+            bool check_signature(bytes&, bytes&, bytes& script_code) const override {
+                ScriptCode = std::vector<byte>(script_code.begin(), script_code.end());
+                return false;
+            }
+        };
+
+        // a signature in the form that the flags require.
+        const std::vector<byte> der{0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01, 0x41};
+
+        // a pubkey for each input.
+        std::vector<byte> key(index i, satoshi amount) {
+            std::vector<byte> p(33, 0);
+            p[0] = 0x02;
+            p[1] = byte(i);
+            p[2] = byte(amount);
+            return p;
+        }
+
+        // accepts any signature with the pubkey of a single input.
+        struct signer : interpreter::checker {
+            index Index;
+            satoshi Amount;
+
+            signer(index i, satoshi amount) : Index{i}, Amount{amount} {}
+
+            bool check_signature(bytes&, bytes& pubkey, bytes&) const override {
+                return pubkey == key(Index, Amount);
+            }
+        };
+
+        struct transaction : interpreter::transaction {
+            pointer<interpreter::checker> input(index i, satoshi amount, uint32) const override {
+                return std::make_shared<signer>(i, amount);
+            }
+        };
+
+    }
+
+    TEST(InterpreterTest, TestScripts) {
+        for (const test& t : scripts) EXPECT_EQ(native(t.Output, t.Input), t.Expected);
+    }
+
+    // the stacks are reused from one run to the next, so nothing
+    // that one script leaves behind must change the next one.
+    TEST(InterpreterTest, TestRandomReuse) {
+        std::mt19937 r{3};
+        std::vector<std::pair<std::vector<byte>, std::vector<byte>>> random{};
+        std::vector<bool> results{};
+        for (int n = 0; n < 10000; n++) {
+            std::vector<byte> output(r() % 12);
+            std::vector<byte> input(r() % 6);
+            for (byte& b : output) b = alphabet[r() % alphabet.size()];
+            for (byte& b : input) b = alphabet[r() % 20];
+            random.push_back({output, input});
+            results.push_back(native(output, input));
+        }
+
+        for (N i = random.size(); i > 0; i--) {
+            EXPECT_EQ(native(random[i - 1].first, random[i - 1].second), results[i - 1]);
+            const test& t = scripts[i % scripts.size()];
+            EXPECT_EQ(native(t.Output, t.Input), t.Expected);
+        }
+    }
+
+    // signatures without the fork id are removed from the script code
+    // that they sign.
+    TEST(InterpreterTest, TestFindAndDelete) {
+        const std::vector<byte> pubkey(33, 0x02);
+        for (N size : {9, 72, 80, 255, 256, 300}) {
+            std::vector<byte> sig(size, 0x30);
+            sig.back() = 0x01;
+
+            const std::vector<byte> output = join({push(sig), {program::OP_DROP}, push(pubkey), push(sig),
+                {program::OP_DROP, program::OP_CHECKSIG}});
+            const std::vector<byte> input = push(sig);
+            const std::vector<byte> expected = join({{program::OP_DROP}, push(pubkey), {program::OP_DROP, program::OP_CHECKSIG}});
+
+            recorder c{};
+            EXPECT_FALSE((interpreter{c, interpreter::verify_none}.run(output, input)));
+            EXPECT_EQ(c.ScriptCode, expected) << "signature of " << size << " bytes";
+        }
+
+        // with the fork id nothing is removed.
+        std::vector<byte> sig(72, 0x30);
+        sig.back() = 0x41;
+        const std::vector<byte> output = join({push(sig), {program::OP_DROP}, push(std::vector<byte>(33, 0x02)), {program::OP_CHECKSIG}});
+        recorder c{};
+        EXPECT_FALSE((interpreter{c, interpreter::enable_fork_id}.run(output, push(sig))));
+        EXPECT_EQ(c.ScriptCode, output);
+    }
+
+    TEST(InterpreterTest, TestMachine) {
+        const transaction tx{};
+        const std::vector<byte> output{program::OP_CHECKSIG};
+        for (index i = 0; i < 3; i++) {
+            const std::vector<byte> input = join({push(der), push(key(i, 100))});
+            EXPECT_TRUE(interpreter_is_machine.run(output, input, tx, i, 100));
+            EXPECT_FALSE(interpreter_is_machine.run(output, input, tx, i + 1, 100));
+            EXPECT_FALSE(interpreter_is_machine.run(output, input, tx, i, 101));
+            EXPECT_FALSE(interpreter_is_machine.run(output, input));
+        }
+        EXPECT_TRUE(interpreter_is_machine.run(std::vector<byte>{program::OP_1}, std::vector<byte>{}));
+    }
+
+}
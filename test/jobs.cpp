@@ -0,0 +1,161 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <thread>
+
+#include <abstractions/work/jobs.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::work {
+
+    namespace {
+
+        using clock = std::chrono::steady_clock;
+
+        // no digest is below this target, in practice.
+        const target impossible{3, 0x000001};
+
+        // a little easier but just as impossible.
+        const target almost_impossible{3, 0x000002};
+
+        // a slice so big that a job which is not interrupted never finishes.
+        const uint64 forever = uint64(1) << 40;
+
+        order make(target t) {
+            return order{sha256::digest{}, message{}, t};
+        }
+
+        // poll until f is true or a long time has passed.
+        template <typename function>
+        bool eventually(function f) {
+            clock::time_point end = clock::now() + std::chrono::seconds(60);
+            while (!f()) {
+                if (clock::now() > end) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        }
+
+    }
+
+    TEST(JobsTest, TestCheckpoint) {
+        order o = make(target{0x1d00ffff});
+        std::copy_n(std::vector<byte>(32, 0xab).begin(), 32, o.Reference.begin());
+        std::copy_n(std::vector<byte>(message_size, 0xcd).begin(), message_size, o.Message.begin());
+        const checkpoint c{o, 0x0123456789abcdef};
+
+        bytes b = c.write();
+        EXPECT_EQ(b.size(), N(checkpoint::size));
+        checkpoint d = checkpoint::read(b);
+        EXPECT_EQ(d.Cursor, c.Cursor);
+        EXPECT_EQ(uint32(d.Order.Target), uint32(o.Target));
+        EXPECT_EQ(d.write(), b);
+
+        EXPECT_EQ(uint32(checkpoint::read(bytes(checkpoint::size - 1, 0xff)).Order.Target), 0);
+    }
+
+    TEST(JobsTest, TestSolve) {
+        jobs j{2};
+        jobs::id i = j.submit(make(easy));
+        EXPECT_EQ(j.wait(i), jobs::solved);
+        EXPECT_EQ(j.state(i), jobs::solved);
+        candidate c = j.solution(i);
+        EXPECT_EQ(uint32(c.target()), uint32(easy));
+        EXPECT_TRUE(c.satisfied(threshold{easy}));
+    }
+
+    TEST(JobsTest, TestExhausted) {
+        jobs j{2, 1000};
+        const uint64 last = uint64(0 - 1);
+        EXPECT_EQ(j.wait(j.resume(checkpoint{make(impossible), last - 5000})), jobs::exhausted);
+        EXPECT_EQ(j.state(j.resume(checkpoint{make(impossible), last})), jobs::exhausted);
+        EXPECT_EQ(j.state(j.submit(order{})), jobs::invalid);
+    }
+
+    TEST(JobsTest, TestOrder) {
+        const uint64 slice = 1 << 12;
+        jobs j{1, slice};
+        jobs::id harder = j.submit(make(impossible));
+        jobs::id easier = j.submit(make(almost_impossible));
+
+        // the harder job may have had one slice before the easier one was submitted.
+        EXPECT_TRUE(eventually([&]() {
+            return j.save(easier).Cursor >= 8 * slice;
+        }));
+        EXPECT_LE(j.save(harder).Cursor, slice);
+        EXPECT_EQ(j.state(harder), jobs::pending);
+    }
+
+    TEST(JobsTest, TestDeadline) {
+        jobs j{1, forever};
+        jobs::id i = j.submit(make(impossible), std::chrono::milliseconds(50));
+        EXPECT_EQ(j.wait(i), jobs::expired);
+        EXPECT_EQ(j.state(i), jobs::expired);
+
+        // the thread gave up part way through its slice.
+        EXPECT_EQ(j.wait(j.submit(make(easy))), jobs::solved);
+
+        // a job that no thread has taken expires too.
+        jobs::id k = j.submit(make(impossible), std::chrono::milliseconds(10));
+        jobs::id l = j.submit(make(impossible), std::chrono::milliseconds(10));
+        EXPECT_EQ(j.wait(k), jobs::expired);
+        EXPECT_EQ(j.wait(l), jobs::expired);
+    }
+
+    TEST(JobsTest, TestPause) {
+        jobs j{1, forever};
+        jobs::id i = j.submit(make(impossible));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        j.pause(i);
+        EXPECT_EQ(j.state(i), jobs::paused);
+
+        // the thread is free for another job.
+        EXPECT_EQ(j.wait(j.submit(make(easy))), jobs::solved);
+
+        // the interrupted slice is remembered.
+        uint64 paused = j.save(i).Cursor;
+        EXPECT_GT(paused, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(j.save(i).Cursor, paused);
+
+        std::vector<checkpoint> c = j.checkpoints();
+        ASSERT_EQ(c.size(), 1);
+        EXPECT_EQ(c[0].Cursor, paused);
+
+        // and continued where it stopped.
+        j.unpause(i);
+        EXPECT_EQ(j.state(i), jobs::pending);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        j.pause(i);
+        EXPECT_TRUE(eventually([&]() {
+            return j.save(i).Cursor > paused;
+        }));
+
+        // a checkpoint can be resumed elsewhere.
+        checkpoint saved = checkpoint::read(j.save(i).write());
+        jobs k{1, forever};
+        EXPECT_GE(k.save(k.resume(saved)).Cursor, saved.Cursor);
+    }
+
+    TEST(JobsTest, TestForget) {
+        jobs j{1, forever};
+        j.forget(1000);
+
+        jobs::id solved = j.submit(make(easy));
+        EXPECT_EQ(j.wait(solved), jobs::solved);
+        j.forget(solved);
+        EXPECT_EQ(j.state(solved), jobs::unknown);
+        EXPECT_EQ(uint32(j.solution(solved).target()), 0);
+
+        // a job that is being searched is cancelled and the thread is freed.
+        jobs::id running = j.submit(make(impossible));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        j.forget(running);
+        EXPECT_EQ(j.state(running), jobs::unknown);
+        EXPECT_EQ(j.wait(running), jobs::unknown);
+        EXPECT_TRUE(j.checkpoints().empty());
+        EXPECT_EQ(j.wait(j.submit(make(easy))), jobs::solved);
+    }
+
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/script/optimize.hpp>
+#include <abstractions/script/interpreter.hpp>
+
+#include <gtest/gtest.h>
+
+// Every rewrite is checked by running the script before and
+// after it through the interpreter and comparing what happens.
+namespace abstractions::script {
+
+    namespace {
+
+        using op = program::op;
+
+        std::vector<byte> join(std::vector<std::vector<byte>> parts) {
+            std::vector<byte> b{};
+            for (const std::vector<byte>& p : parts) b.insert(b.end(), p.begin(), p.end());
+            return b;
+        }
+
+        std::vector<byte> push(std::vector<byte> b) {
+            flat f{};
+            f.push(b);
+            return f.compile();
+        }
+
+        const std::vector<std::vector<byte>> values{
+            {}, {0}, {1}, {2}, {3}, {5}, {0x81}, {0xaa}, {0xbb}, {0xaa, 0xbb}, {0xbb, 0xaa}};
+
+        // scripts to run after a script that look at what it left on the stack.
+        std::vector<std::vector<byte>> probes() {
+            std::vector<std::vector<byte>> p{{}, {program::OP_DROP, program::OP_1}, {program::OP_2DROP, program::OP_1}};
+            for (op d : {program::OP_0, program::OP_1, program::OP_2, program::OP_3})
+                p.push_back({program::OP_DEPTH, d, program::OP_NUMEQUAL});
+            for (const std::vector<byte>& v : values) {
+                p.push_back(join({push(v), {program::OP_EQUAL}}));
+                p.push_back(join({{program::OP_DROP}, push(v), {program::OP_EQUAL}}));
+            }
+            return p;
+        }
+
+        const interpreter::checker nothing{};
+
+        // the stacks that the scripts are run on.
+        const std::vector<std::vector<byte>> inputs{
+            {}, {program::OP_1}, {program::OP_0}, {program::OP_1, program::OP_1}, {program::OP_1, program::OP_2},
+            {program::OP_2, program::OP_3}, {0x01, 0xaa, 0x01, 0xbb}, {0x02, 0xaa, 0xbb, program::OP_1}};
+
+        // optimize a script and check that it does what it did before.
+        optimized check(bytes& script) {
+            const std::vector<std::vector<byte>> after = probes();
+            optimized o = optimize(flat{script});
+            std::vector<byte> rewritten = o.Program.compile();
+            EXPECT_LE(rewritten.size(), script.size());
+            for (uint32 flags : {uint32(interpreter::verify_none), uint32(interpreter::verify_minimal_data)}) {
+                const interpreter x{nothing, flags};
+                for (const std::vector<byte>& p : after)
+                    for (const std::vector<byte>& i : inputs) {
+                        bytes before = join({script, p});
+                        bytes now = join({rewritten, p});
+                        EXPECT_EQ(x.run(now, i), x.run(before, i)) << flags;
+                    }
+            }
+            return o;
+        }
+
+    }
+
+    TEST(OptimizeTest, TestVerify) {
+        for (op o : {program::OP_EQUAL, program::OP_NUMEQUAL, program::OP_CHECKSIG}) {
+            optimized x = check(std::vector<byte>{o, program::OP_VERIFY, program::OP_1});
+            EXPECT_EQ(x.saved(), 1);
+        }
+    }
+
+    TEST(OptimizeTest, TestDrop) {
+        EXPECT_EQ(check(std::vector<byte>{0x01, 0xaa, program::OP_DROP}).after(), 0);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_1, program::OP_2, program::OP_2DROP, program::OP_1}).after(), 1);
+
+        // pushes that fail if minimal data is required stay.
+        EXPECT_EQ(check(std::vector<byte>{0x01, 0x05, program::OP_DROP, program::OP_1}).saved(), 0);
+        EXPECT_EQ(check(std::vector<byte>{0x01, 0x81, program::OP_DROP, program::OP_1}).saved(), 0);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_PUSHDATA1, 0x01, 0xaa, program::OP_DROP, program::OP_1}).saved(), 0);
+
+        // as do pushes that are too large.
+        EXPECT_EQ(check(join({push(std::vector<byte>(521, 1)), {program::OP_DROP, program::OP_1}})).saved(), 0);
+    }
+
+    TEST(OptimizeTest, TestConstants) {
+        EXPECT_EQ(check(std::vector<byte>{0x01, 0xaa, 0x01, 0xbb, program::OP_CAT}).after(), 3);
+        EXPECT_EQ(check(std::vector<byte>{0x02, 0xaa, 0xbb, program::OP_1, program::OP_SPLIT}).after(), 4);
+        EXPECT_EQ(check(std::vector<byte>{0x02, 0xaa, 0xbb, program::OP_0, program::OP_SPLIT}).after(), 4);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_1, program::OP_2, program::OP_SWAP}).after(), 2);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_2, program::OP_3, program::OP_ADD}).after(), 1);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_2, program::OP_3, program::OP_SUB}).after(), 1);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_2, program::OP_2, program::OP_SUB}).after(), 1);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_16, program::OP_16, program::OP_ADD}).after(), 2);
+
+        // what cannot be done ahead of time is left alone.
+        EXPECT_EQ(check(std::vector<byte>{0x02, 0xaa, 0xbb, program::OP_3, program::OP_SPLIT}).saved(), 0);
+        EXPECT_EQ(check(std::vector<byte>{0x02, 0x01, 0x00, program::OP_1, program::OP_ADD}).saved(), 0);
+        EXPECT_EQ(check(std::vector<byte>{0x01, 0x05, program::OP_1, program::OP_ADD}).saved(), 0);
+    }
+
+    TEST(OptimizeTest, TestSwap) {
+        EXPECT_EQ(check(std::vector<byte>{program::OP_SWAP, program::OP_EQUAL}).saved(), 1);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_SWAP, program::OP_ADD}).saved(), 1);
+        EXPECT_EQ(check(std::vector<byte>{program::OP_SWAP, program::OP_SUB}).saved(), 0);
+    }
+
+    TEST(OptimizeTest, TestUntouched) {
+        // pushes that are not rewritten are written as they were.
+        for (std::vector<byte> b : std::vector<std::vector<byte>>{
+            {0x01, 0x00}, {0x01, 0x81}, {0x01, 0x05}, {program::OP_PUSHDATA1, 0x01, 0xaa}, {program::OP_PUSHDATA2, 0x00, 0x00}}) {
+            b.push_back(program::OP_DUP);
+            EXPECT_EQ(check(b).Program.compile(), b);
+        }
+    }
+
+}
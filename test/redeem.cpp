@@ -0,0 +1,66 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/wallet/spendable.hpp>
+#include <abstractions/wallet/machine.hpp>
+#include <abstractions/script/pay_to_pubkey.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::bitcoin {
+
+    namespace {
+
+        // signs an input and pushes the signature.
+        struct signer final : abstractions::pattern::abstract::redeemer<const secret&, const script, const sighash::context&> {
+            script redeem(satoshi amount, script s, const sighash::context& c, index i, const secret& k) const final override {
+                signature x = sign(output{amount, s}, c, i, k);
+                return abstractions::script::redeem_from_pay_to_pubkey(x)->compile();
+            }
+        };
+
+    }
+
+    TEST(RedeemTest, TestThreads) {
+        const secret k{string{"KwdMAjGmerYanjeui5SHS7JkmpZvVipYvB2LJGU1ZxJwYvP98617"}};
+        const signer s{};
+        const script pay{0x76, 0xa9, 0x88, 0xac};
+
+        std::vector<spendable> inputs{};
+        for (index i = 0; i < 20; i++)
+            inputs.push_back(spendable{k, output{1000 + i, pay}, vertex::outpoint{txid{}, i}, s});
+
+        const vertex v{inputs, {output{15000, pay}, output{5000, pay}}};
+        const vertex::transaction serial = v.redeem();
+        EXPECT_TRUE(serial.valid());
+
+        // 0 means one thread per core.
+        for (N threads : {1, 2, 3, 8, 32, 0})
+            EXPECT_EQ(static_cast<bytes&>(v.redeem(threads)), static_cast<bytes&>(serial)) << threads << " threads";
+    }
+
+    TEST(RedeemTest, TestVerify) {
+        const secret k{string{"KwdMAjGmerYanjeui5SHS7JkmpZvVipYvB2LJGU1ZxJwYvP98617"}};
+        const signer s{};
+        const script pay = abstractions::script::templates::pay_to(k.to_public());
+
+        std::vector<spendable> inputs{};
+        std::vector<output> spent{};
+        for (index i = 0; i < 20; i++) {
+            spent.push_back(output{1000 + i, pay});
+            inputs.push_back(spendable{k, spent.back(), vertex::outpoint{txid{}, i}, s});
+        }
+
+        const transaction tx{static_cast<bytes&>(vertex{inputs, {output{15000, pay}, output{5000, pay}}}.redeem())};
+        for (N threads : {1, 2, 3, 8, 32, 0}) EXPECT_TRUE(verify(tx, spent, threads)) << threads << " threads";
+
+        // an amount other than the one that was signed.
+        spent[7].Value += 1;
+        for (N threads : {1, 8}) EXPECT_FALSE(verify(tx, spent, threads)) << threads << " threads";
+        spent[7].Value -= 1;
+
+        // the signatures have the fork id.
+        EXPECT_FALSE(verify(tx, spent, 1, abstractions::script::interpreter::verify_all));
+    }
+
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+#include <abstractions/select.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::select {
+
+    namespace {
+
+        // a selection either pays the amount, the fee, and the change
+        // with the outputs it chooses or it is not valid.
+        void check(const std::vector<satoshi>& values, satoshi amount, const options& o, const selection& s) {
+            if (!s.valid()) return;
+            satoshi value = 0;
+            for (N i = 0; i < s.Inputs.size(); i++) {
+                ASSERT_LT(s.Inputs[i], values.size());
+                if (i > 0) EXPECT_LT(s.Inputs[i - 1], s.Inputs[i]);
+                EXPECT_GT(values[s.Inputs[i]], o.fee(o.InputSize));
+                value += values[s.Inputs[i]];
+            }
+            EXPECT_EQ(s.Value, value);
+            EXPECT_EQ(s.Value, amount + s.Fee + s.Change);
+            if (s.Change != 0) {
+                EXPECT_GE(s.Change, o.Dust);
+                EXPECT_EQ(s.Fee, o.fee_for_inputs(s.Inputs.size()) + o.fee(o.ChangeSize));
+            } else EXPECT_GE(s.Fee, o.fee_for_inputs(s.Inputs.size()));
+        }
+
+        const options free{0, 0, 0, 0, 0, 0};
+
+        // the values of the outputs chosen, from least to most.
+        std::vector<satoshi> chosen(const std::vector<satoshi>& values, const selection& s) {
+            std::vector<satoshi> x{};
+            for (N i : s.Inputs) x.push_back(values[i]);
+            std::sort(x.begin(), x.end());
+            return x;
+        }
+
+    }
+
+    TEST(SelectTest, TestNothing) {
+        for (const options& o : {standard, free}) {
+            EXPECT_FALSE(branch_and_bound({}, 1000, o).valid());
+            EXPECT_FALSE(largest_first({}, 1000, o).valid());
+            EXPECT_FALSE(knapsack({}, 1000, o).valid());
+            EXPECT_FALSE(coins({}, 1000, o).valid());
+            EXPECT_FALSE(coins({}, 0, o).valid());
+        }
+    }
+
+    TEST(SelectTest, TestNotEnough) {
+        const std::vector<satoshi> values{1000, 2000, 3000};
+        EXPECT_FALSE(coins(values, 6001, free).valid());
+        EXPECT_FALSE(coins(values, 5600, standard).valid());
+        EXPECT_TRUE(coins(values, 5000, standard).valid());
+    }
+
+    TEST(SelectTest, TestZero) {
+        // every output pays for everything alone, so
+        // there is nothing smaller for the knapsack.
+        const std::vector<satoshi> values{5, 7};
+        selection s = knapsack(values, 0, free);
+        EXPECT_TRUE(s.valid());
+        check(values, 0, free, s);
+        check(values, 0, free, coins(values, 0, free));
+    }
+
+    TEST(SelectTest, TestDust) {
+        // outputs that cost more to spend than they are worth.
+        const std::vector<satoshi> values{100, 148, 149};
+        EXPECT_FALSE(coins(values, 1, standard).valid());
+        EXPECT_FALSE(largest_first(values, 0, standard).valid());
+    }
+
+    TEST(SelectTest, TestExact) {
+        // 6148 and 4158 are worth 6000 and 4010 after the fee for
+        // each input, which pays 10000 and the fee for the rest.
+        const std::vector<satoshi> values{20000, 6148, 3000, 4158};
+        selection s = branch_and_bound(values, 10000, standard);
+        EXPECT_EQ(s.Inputs, (std::vector<N>{1, 3}));
+        EXPECT_EQ(s.Change, 0);
+        EXPECT_EQ(s.Fee, 306);
+        EXPECT_EQ(s.Waste, 0);
+        EXPECT_EQ(coins(values, 10000, standard).Inputs, s.Inputs);
+    }
+
+    TEST(SelectTest, TestRounding) {
+        // the fee for each input is rounded down on its own, so two
+        // inputs cost 455 and not the 456 that 304 bytes would.
+        const options o{1500, 1500, 10, 147, 34, 546};
+        EXPECT_EQ(o.fee_for_inputs(2), 455);
+        const std::vector<satoshi> values{1220, 1220};
+        selection s = branch_and_bound(values, 1985, o);
+        EXPECT_EQ(s.Inputs, (std::vector<N>{0, 1}));
+        EXPECT_EQ(s.Fee, 455);
+        EXPECT_EQ(s.Change, 0);
+        EXPECT_EQ(s.Waste, 0);
+        check(values, 1985, o, s);
+    }
+
+    TEST(SelectTest, TestLargestFirst) {
+        const std::vector<satoshi> values{1000, 50000, 2000};
+        selection s = largest_first(values, 10000, standard);
+        EXPECT_EQ(s.Inputs, (std::vector<N>{1}));
+        EXPECT_EQ(s.Fee, 192);
+        EXPECT_EQ(s.Change, 39808);
+        check(values, 10000, standard, s);
+    }
+
+    TEST(SelectTest, TestNoChange) {
+        // change smaller than dust goes to the miner.
+        const std::vector<satoshi> values{10500};
+        selection s = largest_first(values, 10000, standard);
+        EXPECT_EQ(s.Change, 0);
+        EXPECT_EQ(s.Fee, 500);
+        check(values, 10000, standard, s);
+    }
+
+    TEST(SelectTest, TestKnapsackSeed) {
+        std::vector<satoshi> values{};
+        for (N i = 0; i < 50; i++) values.push_back(1000 + 37 * i);
+        selection a = knapsack(values, 20000, standard, 5);
+        selection b = knapsack(values, 20000, standard, 5);
+        EXPECT_TRUE(a.valid());
+        EXPECT_EQ(a.Inputs, b.Inputs);
+        check(values, 20000, standard, a);
+    }
+
+    TEST(SelectTest, TestRandom) {
+        std::mt19937 r{4};
+        for (int n = 0; n < 500; n++) {
+            std::vector<satoshi> values(r() % 20);
+            for (satoshi& v : values) v = r() % 100000;
+            satoshi amount = r() % 300000;
+            for (const options& o : {standard, free}) {
+                check(values, amount, o, branch_and_bound(values, amount, o));
+                check(values, amount, o, largest_first(values, amount, o));
+                check(values, amount, o, knapsack(values, amount, o, n));
+                check(values, amount, o, coins(values, amount, o));
+
+                // outputs from most to least valuable are not sorted again,
+                // and the same values are chosen as in any other order.
+                std::vector<satoshi> sorted = values;
+                std::sort(sorted.begin(), sorted.end(), std::greater<satoshi>{});
+                selection a = coins(values, amount, o);
+                selection b = coins(sorted, amount, o);
+                check(sorted, amount, o, b);
+                EXPECT_EQ(chosen(sorted, b), chosen(values, a));
+                EXPECT_EQ(b.Fee, a.Fee);
+                EXPECT_EQ(b.Change, a.Change);
+
+                // if everything together pays, something is found.
+                satoshi total = 0;
+                for (satoshi v : values) if (v > o.fee(o.InputSize)) total += v - o.fee(o.InputSize);
+                if (total >= amount + o.fee(o.BaseSize) + o.cost_of_change() + o.Dust)
+                    EXPECT_TRUE(coins(values, amount, o).valid());
+            }
+        }
+    }
+
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <random>
+
+#include <abstractions/crypto/hash/sha256.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::sha256 {
+
+    namespace {
+
+        std::array<byte, 32> hex(const std::string& x) {
+            std::array<byte, 32> b{};
+            for (N i = 0; i < 32; i++) b[i] = byte(std::stoul(x.substr(2 * i, 2), nullptr, 16));
+            return b;
+        }
+
+        std::array<byte, 32> digits(const digest& d) {
+            std::array<byte, 32> b{};
+            std::copy(d.begin(), d.end(), b.begin());
+            return b;
+        }
+
+        // hash the same message in every lane.
+        std::vector<std::array<byte, 32>> finish(const implementation& x, const midstate& m, const std::string& tail) {
+            std::vector<byte> tails{};
+            for (N j = 0; j < x.Lanes; j++) tails.insert(tails.end(), tail.begin(), tail.end());
+            std::vector<digest> out(x.Lanes);
+            x.Finish(m, tails.data(), tail.size(), out.data());
+            std::vector<std::array<byte, 32>> b{};
+            for (const digest& d : out) b.push_back(digits(d));
+            return b;
+        }
+
+        struct known {
+            std::string Message;
+            std::string Digest;
+        };
+
+        // the first three are from FIPS 180-2.
+        const std::vector<known> fips{
+            {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+            {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+            {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+                "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+            {std::string(1000, 'a'), "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3"}};
+
+    }
+
+    TEST(SHA256Test, TestFIPS) {
+        for (const implementation& x : implementations()) for (const known& v : fips) {
+            std::array<byte, 32> expected = hex(v.Digest);
+            for (const std::array<byte, 32>& d : finish(x, midstate{}, v.Message)) EXPECT_EQ(d, expected) << x.Name << " \"" << v.Message << "\"";
+
+            // the same with as much as possible compressed beforehand.
+            midstate m{reinterpret_cast<const byte*>(v.Message.data()), v.Message.size()};
+            for (const std::array<byte, 32>& d : finish(x, m, v.Message.substr(m.Length))) EXPECT_EQ(d, expected) << x.Name << " \"" << v.Message << "\" with midstate";
+        }
+    }
+
+    TEST(SHA256Test, TestHeaders) {
+        std::mt19937 r{1};
+        for (const implementation& x : implementations()) for (int n = 0; n < 64; n++) {
+            std::vector<std::array<byte, 80>> headers(x.Lanes);
+            for (std::array<byte, 80>& h : headers) for (byte& b : h) b = byte(r());
+
+            // all lanes share the first block, as when mining.
+            for (std::array<byte, 80>& h : headers) std::copy(headers[0].begin(), headers[0].begin() + 64, h.begin());
+            midstate m = prefix<80>(headers[0]);
+
+            std::vector<byte> tails{};
+            for (const std::array<byte, 80>& h : headers) tails.insert(tails.end(), h.begin() + 64, h.end());
+            std::vector<digest> out(x.Lanes);
+            x.Finish(m, tails.data(), 16, out.data());
+
+            for (N j = 0; j < x.Lanes; j++)
+                EXPECT_EQ(digits(out[j]), digits(hash(bytes(headers[j].begin(), headers[j].end())))) << x.Name << " lane " << j;
+        }
+    }
+
+    TEST(SHA256Test, TestFinish) {
+        // more messages than lanes and a number that does not divide evenly.
+        std::mt19937 r{2};
+        const N count = 3 * max_lanes + 1;
+        std::vector<std::array<byte, 80>> headers(count);
+        for (std::array<byte, 80>& h : headers) for (byte& b : h) b = byte(r());
+
+        std::vector<byte> tails{};
+        for (const std::array<byte, 80>& h : headers) tails.insert(tails.end(), h.begin(), h.end());
+        std::vector<digest> out(count);
+        sha256::finish(midstate{}, tails.data(), 80, count, out.data());
+
+        for (N j = 0; j < count; j++) EXPECT_EQ(digits(out[j]), digits(hash<80>(headers[j]))) << "message " << j;
+    }
+
+}
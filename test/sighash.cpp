@@ -0,0 +1,94 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/wallet/transaction.hpp>
+
+#include <gtest/gtest.h>
+
+// The examples from BIP 143. The fork id only changes the
+// last byte of the preimage, so they are hashed without it.
+namespace abstractions::bitcoin::sighash {
+
+    namespace {
+
+        std::vector<byte> hex(const std::string& x) {
+            std::vector<byte> b(x.size() / 2);
+            for (N i = 0; i < b.size(); i++) b[i] = byte(std::stoul(x.substr(2 * i, 2), nullptr, 16));
+            return b;
+        }
+
+        std::vector<byte> digits(const sha256::digest& d) {
+            return std::vector<byte>(d.begin(), d.end());
+        }
+
+        // native P2WPKH.
+        const std::string p2wpkh =
+            "0100000002fff7f7881a8099afa6940d42d1e7f6362bec38171ea3edf433541db4e4ad969f0000000000eeffffff"
+            "ef51e1b804cc89d182d279655c3aa89e815b1b309fe287d9b2b55d57b90ec68a0100000000ffffffff02202cb206"
+            "000000001976a9148280b37df378db99f66f85c95a783a76ac7a6d5988ac9093510d000000001976a9143bde42db"
+            "ee7e4dbe6a21b2d50ce2f0167faa815988ac11000000";
+
+        // P2WSH with six signatures, one of each type.
+        const std::string p2wsh =
+            "010000000136641869ca081e70f394c6948e8af409e18b619df2ed74aa106c1ca29787b96e0100000000ffffffff"
+            "0200e9a435000000001976a914389ffce9cd9ae88dcc0631e88a821ffdbe9bfe2688acc0832f05000000001976a9"
+            "147480a33f950689af511e6e84c138dbbd3c3ee41588ac00000000";
+
+        const std::string p2wsh_script_code =
+            "56210307b8ae49ac90a048e9b53357a2354b3334e9c8bee813ecb98e99a7e07e8c3ba32103b28f0c28bfab54554a"
+            "e8c658ac5c3e0ce6e79ad336331f78c428dd43eea8449b21034b8113d703413d57761b8b9781957b8c0ac1dfe69f"
+            "492580ca4195f50376ba4a21033400f6afecb833092a9a21cfdf1ed1376e58c5d1f47de74683123987e967a8f421"
+            "03a6d48b1131e94ba04d9737d61acdaa1322008af9602b3b14862c07a1789aac162102d8b661b0b3302ee2f162b0"
+            "9e07a55ad5dfbe673a9f01d9f0c19617681024306b56ae";
+
+        struct known {
+            uint32 Directive;
+            std::string Hash;
+        };
+
+    }
+
+    TEST(SighashTest, TestAll) {
+        const context c{hex(p2wpkh)};
+        ASSERT_TRUE(c.valid());
+        EXPECT_EQ(c.inputs(), 2);
+        EXPECT_EQ(digits(c.hash(1, hex("76a9141d0f172a0ecb48aee1be1f2687d2963ae33f71a188ac"), 600000000, all)),
+            hex("c37af31116d1b27caf68aae9e3ac82f1477929014d5b917657d0eb49478cb670"));
+    }
+
+    TEST(SighashTest, TestDirectives) {
+        const context c{hex(p2wsh)};
+        ASSERT_TRUE(c.valid());
+        const std::vector<byte> script_code = hex(p2wsh_script_code);
+        for (const known& k : std::vector<known>{
+            {all, "185c0be5263dce5b4bb50a047973c1b6272bfbd0103a89444597dc40b248ee7c"},
+            {none, "e9733bc60ea13c95c6527066bb975a2ff29a925e80aa14c213f686cbae5d2f36"},
+            {single, "1e1f1c303dc025bd664acb72e583e933fae4cff9148bf78c157d1e8f78530aea"},
+            {all | anyone_can_pay, "2a67f03e63a6a422125878b40b82da593be8d4efaafe88ee528af6e5a9955c6e"},
+            {none | anyone_can_pay, "781ba15f3779d5542ce8ecb5c18716733a5ee42a6f51488ec96154934e2c890a"},
+            {single | anyone_can_pay, "511e8e52ed574121fc1b654970395502128263f62662e076dc6baf05c2e6a99b"}})
+            EXPECT_EQ(digits(c.hash(0, script_code, 987654321, k.Directive)), hex(k.Hash)) << k.Directive;
+    }
+
+    TEST(SighashTest, TestInvalid) {
+        std::vector<byte> truncated = hex(p2wsh);
+        truncated.pop_back();
+        EXPECT_FALSE(context{truncated}.valid());
+        EXPECT_FALSE(context{}.valid());
+        EXPECT_EQ(digits(context{hex(p2wsh)}.hash(1, hex(p2wsh_script_code), 987654321)), digits(sha256::digest{}));
+    }
+
+    TEST(SighashTest, TestSign) {
+        const secret k{string{"KwdMAjGmerYanjeui5SHS7JkmpZvVipYvB2LJGU1ZxJwYvP98617"}};
+        const context c{hex(p2wpkh)};
+        const output o{600000000, hex("76a9141d0f172a0ecb48aee1be1f2687d2963ae33f71a188ac")};
+        for (uint32 d : {all | fork_id, single | fork_id | anyone_can_pay}) {
+            signature x = sign(o, c, 1, k, d);
+            ASSERT_FALSE(x.empty());
+            EXPECT_EQ(x.back(), byte(d));
+            x.pop_back();
+            EXPECT_TRUE(k.to_public().verify(c.hash(1, o.ScriptPubKey, o.Value, d), x));
+        }
+    }
+
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <abstractions/wallet/transaction.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::bitcoin {
+
+    namespace {
+
+        const script pay{0x76, 0xa9, 0x88, 0xac};
+
+        input spend(index i) {
+            return input{outpoint{txid{}, i}, script{0x51, byte(i)}, 0xffffffff - i};
+        }
+
+        std::vector<transaction::representation> examples() {
+            const op_return data{output{0, script{abstractions::script::program::OP_RETURN, 0x01, 0xaa}}};
+            return {
+                transaction::representation{std::vector<input>{spend(0)}, std::vector<output>{output{1000, pay}}},
+                transaction::representation{
+                    std::vector<input>{spend(0), spend(1), spend(2)},
+                    std::vector<output>{output{1000, pay}, output{2000, pay}}, 500000},
+                transaction::representation{std::vector<input>{spend(3)}, data, std::vector<output>{output{3000, pay}}, 0},
+                transaction::representation{std::vector<input>{spend(4), spend(5)}, std::vector<output>{output{4000, pay}}, data}};
+        }
+
+    }
+
+    // however a transaction's id is found, it is the same.
+    TEST(TransactionTest, TestCachedId) {
+        for (const transaction::representation& r : examples()) {
+            const transaction t{r};
+            ASSERT_TRUE(t.valid());
+            const txid id = t.id();
+
+            // written and hashed right away.
+            const cached_transaction w = write(r);
+            EXPECT_EQ(static_cast<bytes&>(w.transaction()), static_cast<bytes&>(t));
+            EXPECT_EQ(w.id(), id);
+
+            // hashed when the id is first needed, and not again.
+            const cached_transaction c{t};
+            EXPECT_EQ(c.id(), id);
+            EXPECT_EQ(c.id(), id);
+
+            // hashed without building a transaction.
+            EXPECT_EQ(r.id(), id);
+        }
+    }
+
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <functional>
+#include <map>
+#include <random>
+
+#include <abstractions/treap.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions {
+
+    namespace {
+
+        struct identity {
+            N operator()(N x) const {
+                return x;
+            }
+        };
+
+        // every key has the same priority.
+        struct constant {
+            N operator()(N) const {
+                return 0;
+            }
+        };
+
+        template <typename hash>
+        using tree = treap<N, N, std::greater<N>, hash>;
+
+        // compare a tree with a map that holds what it ought to, in the same order.
+        template <typename hash>
+        void check(const tree<hash>& t, const std::map<N, N, std::greater<N>>& m) {
+            EXPECT_EQ(t.size(), m.size());
+            EXPECT_EQ(t.empty(), m.empty());
+            auto e = m.begin();
+            t.for_each([&m, &e](N k, N v) {
+                ASSERT_NE(e, m.end()) << "key " << k;
+                EXPECT_EQ(k, e->first);
+                EXPECT_EQ(v, e->second);
+                e++;
+            });
+            EXPECT_EQ(e, m.end());
+            for (const auto& x : m) {
+                const N* v = t.find(x.first);
+                ASSERT_NE(v, nullptr) << "key " << x.first;
+                EXPECT_EQ(*v, x.second);
+            }
+        }
+
+        // insert and remove at random and keep every version along the way.
+        template <typename hash>
+        void random(N keys, N steps, uint32 seed) {
+            std::mt19937 r{seed};
+            std::vector<tree<hash>> trees{tree<hash>{}};
+            std::vector<std::map<N, N, std::greater<N>>> maps{std::map<N, N, std::greater<N>>{}};
+            for (N n = 0; n < steps; n++) {
+                N k = r() % keys;
+                tree<hash> t = trees.back();
+                std::map<N, N, std::greater<N>> m = maps.back();
+                if (r() % 3 == 0) {
+                    t = t.remove(k);
+                    m.erase(k);
+                    EXPECT_FALSE(t.contains(k));
+                } else {
+                    N v = r();
+                    t = t.insert(k, v);
+                    m[k] = v;
+                }
+                trees.push_back(t);
+                maps.push_back(m);
+            }
+            for (N i = 0; i < trees.size(); i++) check(trees[i], maps[i]);
+        }
+
+    }
+
+    TEST(TreapTest, TestEmpty) {
+        tree<identity> t{};
+        EXPECT_TRUE(t.empty());
+        EXPECT_EQ(t.find(0), nullptr);
+        EXPECT_TRUE(t.remove(0).empty());
+    }
+
+    TEST(TreapTest, TestInsertRemove) {
+        random<identity>(100, 2000, 1);
+        random<identity>(100000, 2000, 2);
+        random<constant>(50, 500, 3);
+    }
+
+    TEST(TreapTest, TestReplace) {
+        tree<identity> a = tree<identity>{}.insert(1, 10);
+        tree<identity> b = a.insert(1, 20);
+        EXPECT_EQ(b.size(), 1);
+        EXPECT_EQ(*a.find(1), 10);
+        EXPECT_EQ(*b.find(1), 20);
+    }
+
+    TEST(TreapTest, TestSnapshot) {
+        // keys in order, which would make a list of an unbalanced tree.
+        tree<identity> a{};
+        for (N i = 0; i < 100000; i++) a = a.insert(i, i);
+        tree<identity> b = a;
+        for (N i = 0; i < 100000; i += 2) b = b.remove(i);
+
+        EXPECT_EQ(a.size(), 100000);
+        EXPECT_EQ(b.size(), 50000);
+        for (N i = 0; i < 100000; i++) EXPECT_EQ(*a.find(i), i);
+        EXPECT_FALSE(b.contains(500));
+        EXPECT_TRUE(b.contains(501));
+
+        N last = 100000;
+        b.for_each([&last](N k, N) {
+            EXPECT_LT(k, last);
+            last = k;
+        });
+    }
+
+}
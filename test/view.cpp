@@ -0,0 +1,267 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <filesystem>
+#include <fstream>
+
+#include <abstractions/view.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::view {
+
+    namespace {
+
+        std::vector<byte> hex(const std::string& x) {
+            std::vector<byte> b(x.size() / 2);
+            for (N i = 0; i < b.size(); i++) b[i] = byte(std::stoul(x.substr(2 * i, 2), nullptr, 16));
+            return b;
+        }
+
+        std::vector<byte> join(std::vector<std::vector<byte>> parts) {
+            std::vector<byte> b{};
+            for (const std::vector<byte>& p : parts) b.insert(b.end(), p.begin(), p.end());
+            return b;
+        }
+
+        std::vector<byte> little(uint64 x, N size) {
+            std::vector<byte> b(size);
+            for (N i = 0; i < size; i++) b[i] = byte(x >> (8 * i));
+            return b;
+        }
+
+        // a var int written with the given first byte, whether or not it is the smallest.
+        std::vector<byte> var_int(byte first, uint64 x) {
+            if (first < 0xfd) return {byte(x)};
+            return join({{first}, little(x, N(1) << (first - 0xfc))});
+        }
+
+        // the genesis block.
+        const std::string genesis_header =
+            "0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b27ac72c3e"
+            "67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c";
+
+        const std::string genesis_transaction =
+            "01000000010000000000000000000000000000000000000000000000000000000000000000ffffffff4d04ffff001d01"
+            "04455468652054696d65732030332f4a616e2f32303039204368616e63656c6c6f72206f6e206272696e6b206f6620"
+            "7365636f6e64206261696c6f757420666f722062616e6b73ffffffff0100f2052a01000000434104678afdb0fe5548"
+            "271967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b"
+            "8d578a4c702b6bf11d5fac00000000";
+
+        std::vector<byte> genesis() {
+            return join({hex(genesis_header), {1}, hex(genesis_transaction)});
+        }
+
+        // a transaction with one input and one output whose counts and
+        // script sizes are written with the given first bytes.
+        std::vector<byte> write_transaction(byte count, byte size, N input_script, N output_script) {
+            return join({
+                little(2, 4), var_int(count, 1),
+                std::vector<byte>(36, 0xaa), var_int(size, input_script), std::vector<byte>(input_script, 0x51), little(0xfffffffe, 4),
+                var_int(count, 1),
+                little(1000, 8), var_int(size, output_script), std::vector<byte>(output_script, 0x6a),
+                little(0x12345678, 4)});
+        }
+
+        std::vector<byte> record(uint32 magic, bytes& block) {
+            return join({little(magic, 4), little(block.size(), 4), block});
+        }
+
+        // a file that is removed when the test is done with it.
+        struct file {
+            std::string Path;
+
+            file(bytes& b) : Path{next()} {
+                std::ofstream o{Path, std::ios::binary};
+                o.write(reinterpret_cast<const char*>(b.data()), b.size());
+            }
+
+            ~file() {
+                std::filesystem::remove(Path);
+            }
+
+            static std::string next() {
+                static int n = 0;
+                return (std::filesystem::temp_directory_path() / ("abstractions_view_" + std::to_string(n++) + ".dat")).string();
+            }
+        };
+
+    }
+
+    TEST(ViewTest, TestGenesis) {
+        std::vector<byte> b = genesis();
+        const block k{b};
+        ASSERT_TRUE(k.valid());
+        EXPECT_EQ(k.transactions(), 1);
+        EXPECT_EQ(std::vector<byte>(k.header().data(), k.header().data() + 80), hex(genesis_header));
+
+        slice<byte> t = k.transaction(0);
+        EXPECT_EQ(std::vector<byte>(t.data(), t.data() + t.size()), hex(genesis_transaction));
+        EXPECT_EQ(k.first_input(0), 0);
+        EXPECT_EQ(k.first_output(0), 0);
+        EXPECT_EQ(k.inputs(), 1);
+        EXPECT_EQ(k.outputs(), 1);
+        EXPECT_EQ(k.value(0), 5000000000);
+        EXPECT_EQ(k.output(0).value(), 5000000000);
+        EXPECT_EQ(k.output(0).script().size(), 67);
+        EXPECT_EQ(k.output(0).script().data()[66], 0xac);
+        EXPECT_EQ(k.input(0).script().size(), 77);
+        EXPECT_EQ(k.input(0).sequence(), 0xffffffff);
+
+        const view::transaction x{t};
+        ASSERT_TRUE(x.valid());
+        EXPECT_EQ(x.size(), t.size());
+        EXPECT_EQ(x.version(), 1);
+        EXPECT_EQ(x.locktime(), 0);
+        EXPECT_EQ(x.serialized_outputs().size(), 76);
+    }
+
+    TEST(ViewTest, TestVarInt) {
+        // each size is read with each way of writing it that fits, both
+        // where the var int is read all at once and near the end, where
+        // it is read a byte at a time.
+        struct encoded {
+            byte First;
+            N Size;
+        };
+
+        for (const encoded& e : std::vector<encoded>{
+            {0, 0}, {0, 0xfc}, {0xfd, 0}, {0xfd, 0xfd}, {0xfd, 0xffff},
+            {0xfe, 0}, {0xfe, 0x10000}, {0xff, 0}, {0xff, 0x10001}}) {
+            for (byte count : {byte(0), byte(0xfd), byte(0xfe), byte(0xff)}) {
+                std::vector<byte> b = write_transaction(count, e.First, e.Size, e.Size);
+                const view::transaction x{b};
+                ASSERT_TRUE(x.valid()) << N(e.First) << " " << e.Size << " " << N(count);
+                EXPECT_EQ(x.size(), b.size());
+                EXPECT_EQ(x.inputs(), 1);
+                EXPECT_EQ(x.outputs(), 1);
+                EXPECT_EQ(x.input(0).script().size(), e.Size);
+                EXPECT_EQ(x.input(0).sequence(), 0xfffffffe);
+                EXPECT_EQ(x.output(0).script().size(), e.Size);
+                EXPECT_EQ(x.output(0).value(), 1000);
+                EXPECT_EQ(x.locktime(), 0x12345678);
+
+                // in a block, with the count of transactions written each way.
+                std::vector<byte> k = join({std::vector<byte>(80, 0), var_int(count, 2), b, b});
+                const block y{k};
+                ASSERT_TRUE(y.valid());
+                EXPECT_EQ(y.transactions(), 2);
+                EXPECT_EQ(y.first_output(1), 1);
+                EXPECT_EQ(y.output(1).script().size(), e.Size);
+                EXPECT_EQ(y.value(1), 1000);
+            }
+        }
+
+        // counts that say more than there could be room for.
+        for (byte first : {byte(0xfd), byte(0xfe), byte(0xff)}) {
+            std::vector<byte> b = write_transaction(0, 0, 1, 1);
+            std::vector<byte> c = join({little(2, 4), var_int(first, (uint64(1) << (8 * (N(1) << (first - 0xfc)) - 1)) | 1),
+                std::vector<byte>(b.begin() + 5, b.end())});
+            EXPECT_FALSE(view::transaction{c}.valid()) << N(first);
+        }
+    }
+
+    TEST(ViewTest, TestTruncated) {
+        std::vector<byte> b = genesis();
+        for (N n = 0; n < b.size(); n++) {
+            std::vector<byte> prefix(b.begin(), b.begin() + n);
+            EXPECT_FALSE(block{prefix}.valid()) << n;
+        }
+
+        // a block ends where its last transaction does.
+        std::vector<byte> longer = join({b, {0}});
+        EXPECT_FALSE(block{longer}.valid());
+
+        std::vector<byte> t = hex(genesis_transaction);
+        for (N n = 0; n < t.size(); n++) {
+            std::vector<byte> prefix(t.begin(), t.begin() + n);
+            EXPECT_FALSE(view::transaction{prefix}.valid()) << n;
+        }
+
+        // but a transaction can be followed by anything.
+        std::vector<byte> followed = join({t, {0xff, 0xff}});
+        const view::transaction x{followed};
+        EXPECT_TRUE(x.valid());
+        EXPECT_EQ(x.size(), t.size());
+    }
+
+    TEST(ViewTest, TestCorrupt) {
+        const N count = 80;
+        const N inputs = count + 1 + 4;
+        const N input_script = inputs + 1 + 36;
+        const N outputs = input_script + 1 + 77 + 4;
+        const N output_script = outputs + 1 + 8;
+
+        // each of the counts and sizes in the genesis block, made larger and smaller.
+        for (N at : {count, inputs, input_script, outputs, output_script})
+            for (int d : {-1, 1}) {
+                std::vector<byte> b = genesis();
+                b[at] = byte(b[at] + d);
+                EXPECT_FALSE(block{b}.valid()) << at << " " << d;
+            }
+
+        // a count too large to reserve memory for.
+        std::vector<byte> b = genesis();
+        b[count] = 0xff;
+        b.insert(b.begin() + count + 1, 8, 0xff);
+        EXPECT_FALSE(block{b}.valid());
+    }
+
+    TEST(ViewTest, TestLimits) {
+        // positions are 32 bits, so a script that would end past them
+        // is not read, even if the slice is said to be big enough.
+        const N huge = N(1) << 33;
+        std::vector<byte> t = write_transaction(0, 0, 1, 1);
+        std::vector<byte> b = join({std::vector<byte>(t.begin(), t.end() - 6), var_int(0xff, uint64(1) << 32), std::vector<byte>(16, 0)});
+        const view::transaction past{slice<byte>{b.data(), huge}};
+        EXPECT_FALSE(past.valid());
+
+        b = join({std::vector<byte>(t.begin(), t.end() - 6), var_int(0xff, 0xffffffff - (t.size() - 6) - 9 - 4 + 1), std::vector<byte>(16, 0)});
+        const view::transaction last{slice<byte>{b.data(), huge}};
+        EXPECT_FALSE(last.valid());
+
+        // a transaction in a large slice is still read.
+        const view::transaction x{slice<byte>{t.data(), huge}};
+        ASSERT_TRUE(x.valid());
+        EXPECT_EQ(x.size(), t.size());
+        EXPECT_EQ(x.output(0).script().size(), 1);
+
+        // a block cannot be that large.
+        std::vector<byte> g = genesis();
+        const block k{slice<byte>{g.data(), huge}};
+        EXPECT_FALSE(k.valid());
+    }
+
+    TEST(ViewTest, TestBlockFile) {
+        std::vector<byte> g = genesis();
+        std::vector<byte> t = write_transaction(0, 0, 1, 1);
+        std::vector<byte> k = join({std::vector<byte>(80, 0), {1}, t});
+
+        // the file ends in zeros, as it does when it has been allocated ahead of time.
+        const file f{join({record(block_file::main_net, g), record(block_file::main_net, k), std::vector<byte>(100, 0)})};
+        const block_file x{f.Path};
+        ASSERT_TRUE(x.valid());
+        ASSERT_EQ(x.blocks(), 2);
+        EXPECT_EQ(x.serialized(0).size(), g.size());
+        EXPECT_TRUE(x.block(0).valid());
+        EXPECT_EQ(x.block(0).value(0), 5000000000);
+        EXPECT_TRUE(x.block(1).valid());
+        EXPECT_EQ(x.block(1).value(0), 1000);
+        EXPECT_EQ(x.serialized(2).size(), 0);
+
+        // a block that is cut off is not read.
+        std::vector<byte> cut = record(block_file::main_net, g);
+        cut.pop_back();
+        const file c{join({record(block_file::main_net, k), cut})};
+        EXPECT_EQ(block_file{c.Path}.blocks(), 1);
+
+        // nor is anything after a record with the wrong magic number.
+        const file m{join({record(block_file::main_net, k), record(0x0709110b, g), record(block_file::main_net, g)})};
+        EXPECT_EQ(block_file{m.Path}.blocks(), 1);
+        const block_file test_net{m.Path, 0x0709110b};
+        EXPECT_EQ(test_net.blocks(), 0);
+
+        EXPECT_FALSE(block_file{f.Path + ".missing"}.valid());
+    }
+
+}
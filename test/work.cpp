@@ -0,0 +1,93 @@
+// Copyright (c) 2019 Daniel Krawisz
+// Distributed under the Open BSV software license, see the accompanying file LICENSE.
+
+#include <random>
+
+#include <abstractions/work/work.hpp>
+
+#include <gtest/gtest.h>
+
+namespace abstractions::work {
+
+    namespace {
+
+        using array = std::array<byte, 32>;
+
+        bool little() {
+            const sha256::digest one = uint256{1};
+            return static_cast<const array&>(one)[0] == 1;
+        }
+
+        // the bytes of a digest, most significant first.
+        array big(const sha256::digest& d) {
+            array b = static_cast<const array&>(d);
+            if (little()) std::reverse(b.begin(), b.end());
+            return b;
+        }
+
+        sha256::digest digest(array b) {
+            if (little()) std::reverse(b.begin(), b.end());
+            sha256::digest d{};
+            static_cast<array&>(d) = b;
+            return d;
+        }
+
+        target random_target(std::mt19937& r) {
+            return target{byte(3 + r() % 30), uint32(1 + r() % 0x00ffffff)};
+        }
+
+    }
+
+    TEST(WorkTest, TestThreshold) {
+        std::mt19937 r{5};
+        std::vector<target> targets{easy, hard, target{0x1d00ffff}, target{32, 0x000fffff}, target{4, 0x00800000}};
+        for (int n = 0; n < 200; n++) targets.push_back(random_target(r));
+
+        for (target t : targets) {
+            const threshold h{t};
+            const sha256::digest expanded = t.expand();
+            EXPECT_FALSE(h.below(expanded)) << t.Encoded;
+            EXPECT_TRUE(h.below(sha256::digest{})) << t.Encoded;
+
+            // digests that share some of the target's bytes and then differ.
+            for (int n = 0; n < 200; n++) {
+                array b = big(expanded);
+                N i = r() % 32;
+                b[i] = byte(r());
+                for (N j = i + 1; j < 32; j++) if (r() % 2) b[j] = byte(r());
+                sha256::digest d = digest(b);
+                EXPECT_EQ(h.below(d), d < expanded) << t.Encoded;
+            }
+        }
+    }
+
+    TEST(WorkTest, TestMagnitude) {
+        std::mt19937 r{6};
+        for (int n = 0; n < 10000; n++) {
+            target a = random_target(r);
+            target b = random_target(r);
+
+            // the same target in another form half of the time.
+            if (n % 2 == 1) {
+                a = target{byte(4 + r() % 29), uint32(1 + r() % 0xffff)};
+                b = target{byte(a.exponent() - 1), a.value() << 8};
+            }
+
+            EXPECT_EQ(a < b, a.expand() < b.expand()) << a.Encoded << " " << b.Encoded;
+            EXPECT_EQ(a > b, b.expand() < a.expand()) << a.Encoded << " " << b.Encoded;
+            EXPECT_EQ(a <= b, !(b.expand() < a.expand())) << a.Encoded << " " << b.Encoded;
+            EXPECT_EQ(a.magnitude() == b.magnitude(), a.expand() == b.expand()) << a.Encoded << " " << b.Encoded;
+        }
+    }
+
+    TEST(WorkTest, TestInvalid) {
+        for (uint32 x : std::vector<uint32>{0x00000000, 0x01000001, 0x0200ffff, 0x02ffffff, 0x21000001, 0xff00ffff, 0x1d000000}) {
+            target t{x};
+            EXPECT_FALSE(t.valid()) << x;
+            EXPECT_EQ(t.magnitude(), 0) << x;
+            EXPECT_TRUE(t < hard) << x;
+            EXPECT_FALSE(threshold{t}.below(sha256::digest{})) << x;
+        }
+    }
+
+}